@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "attacks.h"
 #include "bitboards.h"
@@ -41,6 +42,8 @@
 
 const char *PieceLabel[COLOUR_NB] = {"PNBRQK", "pnbrqk"};
 
+extern volatile int ABORT_SIGNAL; // Defined by Search.c
+
 static const char *Benchmarks[] = {
     #include "bench.csv"
     ""
@@ -64,6 +67,7 @@ static void setSquare(Board *board, int colour, int piece, int sq) {
 
     board->psqtmat += PSQT[board->squares[sq]][sq];
     board->hash ^= ZobristKeys[board->squares[sq]][sq];
+    board->mhash += ZobristMaterialKeys[board->squares[sq]][sq];
     if (piece == PAWN || piece == KING)
         board->pkhash ^= ZobristKeys[board->squares[sq]][sq];
 }
@@ -143,8 +147,9 @@ void boardFromFEN(Board *board, const char *fen) {
     // Move count: ignore and use zero, as we count since root
     board->numMoves = 0;
 
-    // Need king attackers for move generation
+    // Need king attackers and pinned pieces for move generation
     board->kingAttackers = attackersToKingSquare(board);
+    board->pinned = pinnedPieces(board, board->turn);
 
     free(str);
 }
@@ -246,34 +251,37 @@ uint64_t perft(Board *board, int depth){
 
     if (depth == 0) return 1ull;
 
-    genAllMoves(board, moves, &size);
+    genAllLegalMoves(board, moves, &size);
 
-    // Recurse on all valid moves
+    // Recurse on all moves, which are known to be legal
     for(size -= 1; size >= 0; size--){
         applyMove(board, moves[size], undo);
-        if (isNotInCheck(board, !board->turn))
-            found += perft(board, depth-1);
+        found += perft(board, depth-1);
         revertMove(board, moves[size], undo);
     }
 
     return found;
 }
 
-void runBenchmark(Thread *threads, int depth) {
+static double benchmarkPositions(Thread *threads, int depth, uint64_t nodeLimit, uint64_t *nodes, TTStats *stats) {
 
-    double start, end;
+    double start;
     Board board;
     Limits limits;
     uint16_t bestMove, ponderMove;
-    uint64_t nodes = 0ull;
 
     // Initialize limits for the search
     limits.limitedByNone  = 0;
     limits.limitedByTime  = 0;
-    limits.limitedByDepth = 1;
+    limits.limitedByDepth = depth != 0 || nodeLimit == 0;
     limits.limitedBySelf  = 0;
+    limits.limitedByNodes = nodeLimit != 0;
     limits.timeLimit      = 0;
     limits.depthLimit     = depth == 0 ? 13 : depth;
+    limits.nodeLimit      = nodeLimit;
+
+    // Consider every legal move in each position
+    limits.searchMovesSize = 0;
 
     start = getRealTime();
 
@@ -283,18 +291,68 @@ void runBenchmark(Thread *threads, int depth) {
         boardFromFEN(&board, Benchmarks[i]);
 
         limits.start = getRealTime();
+        ABORT_SIGNAL = 0; // Clear the ABORT signal for the new search
         getBestMove(threads, &board, &limits, &bestMove, &ponderMove);
-        nodes += nodesSearchedThreadPool(threads);
+        *nodes += nodesSearchedThreadPool(threads);
+        ttstatsThreadPool(threads, stats);
 
-        clearTT(); // Reset TT for new search
+        clearTT(threads); // Reset TT for new search
     }
 
-    end = getRealTime();
+    return getRealTime() - start;
+}
+
+void runBenchmark(Thread *threads, int depth, uint64_t nodeLimit) {
+
+    uint64_t nodes = 0ull;
+    TTStats stats = {0};
+
+    double elapsed = benchmarkPositions(threads, depth, nodeLimit, &nodes, &stats);
 
     printf("\n------------------------\n");
-    printf("Time  : %dms\n", (int)(end - start));
+    printf("Time  : %dms\n", (int)elapsed);
     printf("Nodes : %"PRIu64"\n", nodes);
-    printf("NPS   : %d\n", (int)(nodes / ((end - start) / 1000.0)));
+    printf("NPS   : %d\n", (int)(nodes / (elapsed / 1000.0)));
+
+    #if defined(TTSTATS)
+        printf("\n");
+        reportTTStats(&stats);
+    #endif
+}
+
+void runScalingBenchmark(int depth, int maxThreads, int megabytes) {
+
+    int counts[32], ncounts = 0;
+    double times[32];
+    uint64_t nodes[32] = {0};
+    TTStats stats = {0};
+
+    // Double the threads each run, always finishing with maxThreads
+    for (int t = 1; t < maxThreads && ncounts < 31; t *= 2)
+        counts[ncounts++] = t;
+    counts[ncounts++] = MAX(1, maxThreads);
+
+    for (int i = 0; i < ncounts; i++) {
+
+        // Each run starts from a fresh pool and an empty table
+        Thread *threads = createThreadPool(counts[i]);
+        initTT(megabytes, threads);
+        clearTT(threads);
+
+        times[i] = benchmarkPositions(threads, depth, 0, &nodes[i], &stats);
+        deleteThreadPool(threads);
+    }
+
+    // NPS and time to depth, each relative to the first run
+    printf("\n-----------------------------------------------------------------------------\n");
+    printf("Threads |   Time(ms) |         Nodes |        NPS | NPS Speedup | TTD Speedup\n");
+
+    for (int i = 0; i < ncounts; i++)
+        printf("%7d | %10d | %13"PRIu64" | %10d | %11.2f | %11.2f\n",
+               counts[i], (int)times[i], nodes[i],
+               (int)(nodes[i] / (times[i] / 1000.0)),
+               (nodes[i] / times[i]) / (nodes[0] / times[0]),
+               times[0] / times[i]);
 }
 
 int boardIsDrawn(Board *board, int height) {
@@ -368,3 +426,154 @@ int drawnByInsufficientMaterial(Board *board) {
 
     return 0;
 }
+
+static double monotonicMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void runLatencyBenchmark(Thread *threads, int searches) {
+
+    Board board;
+    Limits limits;
+    uint16_t bestMove, ponderMove;
+    double start, total = 0.0;
+
+    searches = MAX(1, searches);
+    double *latencies = malloc(sizeof(double) * searches);
+
+    // A depth one search sends exactly one info line, so its
+    // wall time is the latency from the go to the first report
+    memset(&limits, 0, sizeof(Limits));
+    limits.limitedByDepth = 1;
+    limits.depthLimit     = 1;
+
+    for (int i = 0; i < searches; i++) {
+
+        // Cycle through the benchmark positions
+        int npositions = 0;
+        while (strcmp(Benchmarks[npositions], "")) npositions++;
+        boardFromFEN(&board, Benchmarks[i % npositions]);
+
+        start = monotonicMicros();
+        limits.start = getRealTime();
+        ABORT_SIGNAL = 0; // Clear the ABORT signal for the new search
+        getBestMove(threads, &board, &limits, &bestMove, &ponderMove);
+        total += latencies[i] = monotonicMicros() - start;
+    }
+
+    qsort(latencies, searches, sizeof(double), compareDoubles);
+
+    printf("\n------------------------\n");
+    printf("Threads  : %d\n", threads[0].nthreads);
+    printf("Searches : %d\n", searches);
+    printf("Mean     : %.1fus\n", total / searches);
+    printf("Median   : %.1fus\n", latencies[searches / 2]);
+    printf("P99      : %.1fus\n", latencies[MIN(searches - 1, searches * 99 / 100)]);
+
+    free(latencies);
+}
+
+static int epdBestMoves(Board *board, char *ops, uint16_t *bestMoves) {
+
+    int size = 0, count = 0;
+    char san[8], *token, *strPos = NULL;
+    uint16_t moves[MAX_MOVES];
+
+    // Locate the bm operation, which lists the solutions in SAN
+    char *bm = strstr(ops, "bm ");
+    if (bm == NULL) return 0;
+    char *end = strchr(bm, ';');
+    if (end != NULL) *end = '\0';
+
+    genAllLegalMoves(board, moves, &size);
+
+    for (token = strtok_r(bm + 3, " ", &strPos); token; token = strtok_r(NULL, " ", &strPos)) {
+
+        // Ignore check, mate and annotation suffixes
+        token[strcspn(token, "+#!?")] = '\0';
+
+        // Match against the SAN of each legal move
+        for (int i = 0; i < size; i++) {
+            moveToSAN(board, moves[i], san);
+            if (stringEquals(san, token))
+                bestMoves[count++] = moves[i];
+        }
+    }
+
+    return count;
+}
+
+void runSolveBenchmark(Thread *threads, const char *fname, int maxTime) {
+
+    Board board;
+    Limits limits;
+    char line[1024], fen[256], *token, *strPos = NULL;
+    uint16_t bestMoves[MAX_MOVES], bestMove, ponderMove;
+    int positions = 0, solved = 0, nbest;
+    double total = 0.0;
+
+    FILE *fin = fopen(fname, "r");
+    if (fin == NULL) {
+        printf("Unable to open %s\n", fname);
+        return;
+    }
+
+    memset(&limits, 0, sizeof(Limits));
+    limits.limitedByTime = 1;
+
+    while (fgets(line, sizeof(line), fin) != NULL) {
+
+        // EPDs hold the first four FEN fields, followed by operations
+        fen[0] = '\0';
+        token = strtok_r(line, " ", &strPos);
+        for (int i = 0; i < 4 && token != NULL; i++) {
+            strcat(fen, token); strcat(fen, " ");
+            token = i < 3 ? strtok_r(NULL, " ", &strPos) : NULL;
+        }
+        strcat(fen, "0 1");
+
+        boardFromFEN(&board, fen);
+        if (!(nbest = epdBestMoves(&board, strPos, bestMoves)))
+            continue;
+
+        positions++;
+
+        // Double the search time until a fresh search finds a solution. The
+        // voted bestmove of the whole pool is what must match the solution
+        int found = 0, time;
+        for (time = 100; time <= maxTime && !found; time *= 2) {
+
+            clearTT(threads);
+            resetThreadPool(threads);
+
+            ABORT_SIGNAL = 0; // Clear the ABORT signal for the new search
+            limits.timeLimit = time;
+            limits.start = getRealTime();
+            getBestMove(threads, &board, &limits, &bestMove, &ponderMove);
+
+            for (int i = 0; i < nbest; i++)
+                found |= bestMove == bestMoves[i];
+        }
+
+        time /= 2;
+        solved += found;
+        total  += found ? time : maxTime;
+
+        printf("\nPosition #%d: %s\n", positions, found ? "solved" : "unsolved");
+        if (found) printf("Time to solution: %dms\n", time);
+    }
+
+    fclose(fin);
+
+    printf("\n------------------------\n");
+    printf("Threads   : %d\n", threads[0].nthreads);
+    printf("Solved    : %d / %d\n", solved, positions);
+    printf("Total TTS : %dms\n", (int)total);
+}
@@ -28,7 +28,9 @@ struct Board {
     uint64_t colours[3];
     uint64_t hash;
     uint64_t pkhash;
+    uint64_t mhash;
     uint64_t kingAttackers;
+    uint64_t pinned;
     int turn;
     int castleRights;
     int epSquare;
@@ -41,7 +43,9 @@ struct Board {
 struct Undo {
     uint64_t hash;
     uint64_t pkhash;
+    uint64_t mhash;
     uint64_t kingAttackers;
+    uint64_t pinned;
     int castleRights;
     int epSquare;
     int fiftyMoveRule;
@@ -56,7 +60,10 @@ void boardToFEN(Board *board, char *fen);
 
 void printBoard(Board *board);
 uint64_t perft(Board *board, int depth);
-void runBenchmark(Thread *threads, int depth);
+void runBenchmark(Thread *threads, int depth, uint64_t nodeLimit);
+void runScalingBenchmark(int depth, int maxThreads, int megabytes);
+void runLatencyBenchmark(Thread *threads, int searches);
+void runSolveBenchmark(Thread *threads, const char *fname, int maxTime);
 
 int boardIsDrawn(Board *board, int height);
 int drawnByFiftyMoveRule(Board *board);
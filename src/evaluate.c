@@ -255,30 +255,28 @@ const int Tempo[COLOUR_NB] = { S(  25,  12), S( -25, -12) };
 
 #undef S
 
-int evaluateBoard(Board* board, PawnKingTable* pktable){
+int evaluateBoard(Board* board, PawnKingTable* pktable, MaterialTable* mtable){
 
     EvalInfo ei;
-    int phase, factor, eval, pkeval;
+    MaterialEntry mcopy, *mentry;
+    int eval, pkeval;
+
+    // Fetch the material only terms, computing them on a miss
+    mentry = mtable == NULL ? NULL : getMaterialEntry(mtable, board->mhash);
+    if (mentry == NULL) {
+        evaluateMaterial(board, mentry = &mcopy);
+        if (mtable != NULL) storeMaterialEntry(mtable, mentry);
+    }
 
     // Setup and perform all evaluations
     initializeEvalInfo(&ei, board, pktable);
     eval   = evaluatePieces(&ei, board);
     pkeval = ei.pkeval[WHITE] - ei.pkeval[BLACK];
-    eval  += pkeval + board->psqtmat + Tempo[board->turn];
-
-    // Calcuate the game phase based on remaining material (Fruit Method)
-    phase = 24 - 4 * popcount(board->pieces[QUEEN ])
-               - 2 * popcount(board->pieces[ROOK  ])
-               - 1 * popcount(board->pieces[KNIGHT]
-                             |board->pieces[BISHOP]);
-    phase = (phase * 256 + 12) / 24;
-
-    // Scale evaluation based on remaining material
-    factor = evaluateScaleFactor(board);
+    eval  += pkeval + board->psqtmat + mentry->imbalance + Tempo[board->turn];
 
     // Compute the interpolated and scaled evaluation
-    eval = (ScoreMG(eval) * (256 - phase)
-         +  ScoreEG(eval) * phase * factor / SCALE_NORMAL) / 256;
+    eval = (ScoreMG(eval) * (256 - mentry->phase)
+         +  ScoreEG(eval) * mentry->phase * mentry->scale / SCALE_NORMAL) / 256;
 
     // Store a new Pawn King Entry if we did not have one
     if (ei.pkentry == NULL && pktable != NULL)
@@ -472,12 +470,6 @@ int evaluateBishops(EvalInfo *ei, Board *board, int colour) {
 
     ei->attackedBy[US][BISHOP] = 0ull;
 
-    // Apply a bonus for having a pair of bishops
-    if ((tempBishops & WHITE_SQUARES) && (tempBishops & BLACK_SQUARES)) {
-        eval += BishopPair;
-        if (TRACE) T.BishopPair[US]++;
-    }
-
     // Evaluate each bishop
     while (tempBishops) {
 
@@ -894,6 +886,37 @@ int evaluateScaleFactor(Board *board) {
     return SCALE_NORMAL;
 }
 
+void evaluateMaterial(Board *board, MaterialEntry *mentry) {
+
+    uint64_t white   = board->colours[WHITE];
+    uint64_t black   = board->colours[BLACK];
+    uint64_t bishops = board->pieces[BISHOP];
+
+    mentry->mhash     = board->mhash;
+    mentry->imbalance = 0;
+
+    // Calcuate the game phase based on remaining material (Fruit Method)
+    mentry->phase = 24 - 4 * popcount(board->pieces[QUEEN ])
+                       - 2 * popcount(board->pieces[ROOK  ])
+                       - 1 * popcount(board->pieces[KNIGHT]
+                                     |board->pieces[BISHOP]);
+    mentry->phase = (mentry->phase * 256 + 12) / 24;
+
+    // Scale evaluation based on remaining material
+    mentry->scale = evaluateScaleFactor(board);
+
+    // Apply a bonus for having a pair of bishops
+    if ((white & bishops & WHITE_SQUARES) && (white & bishops & BLACK_SQUARES)) {
+        mentry->imbalance += BishopPair;
+        if (TRACE) T.BishopPair[WHITE]++;
+    }
+
+    if ((black & bishops & WHITE_SQUARES) && (black & bishops & BLACK_SQUARES)) {
+        mentry->imbalance -= BishopPair;
+        if (TRACE) T.BishopPair[BLACK]++;
+    }
+}
+
 void initializeEvalInfo(EvalInfo* ei, Board* board, PawnKingTable* pktable){
 
     uint64_t white   = board->colours[WHITE];
@@ -938,7 +961,7 @@ void initializeEvalInfo(EvalInfo* ei, Board* board, PawnKingTable* pktable){
     ei->kingAttackersCount[WHITE]  = ei->kingAttackersCount[BLACK]  = 0;
     ei->kingAttackersWeight[WHITE] = ei->kingAttackersWeight[BLACK] = 0;
 
-    ei->pkentry       =     pktable == NULL ? NULL : getPawnKingEntry(pktable, board->pkhash);
+    ei->pkentry       =     pktable == NULL ? NULL : getPawnKingEntry(pktable, board->pkhash, &ei->pkcopy);
     ei->passedPawns   = ei->pkentry == NULL ? 0ull : ei->pkentry->passed;
     ei->pkeval[WHITE] = ei->pkentry == NULL ? 0    : ei->pkentry->eval;
     ei->pkeval[BLACK] = ei->pkentry == NULL ? 0    : 0;
@@ -19,6 +19,7 @@
 #ifndef _EVALUATE_H
 #define _EVALUATE_H
 
+#include "transposition.h"
 #include "types.h"
 
 enum {
@@ -93,9 +94,10 @@ struct EvalInfo {
     int kingAttackersWeight[COLOUR_NB];
     int pkeval[COLOUR_NB];
     PawnKingEntry* pkentry;
+    PawnKingEntry pkcopy;
 };
 
-int evaluateBoard(Board *board, PawnKingTable *pktable);
+int evaluateBoard(Board *board, PawnKingTable *pktable, MaterialTable *mtable);
 int evaluatePieces(EvalInfo *ei, Board *board);
 int evaluatePawns(EvalInfo *ei, Board *board, int colour);
 int evaluateKnights(EvalInfo *ei, Board *board, int colour);
@@ -106,6 +108,7 @@ int evaluateKings(EvalInfo *ei, Board *board, int colour);
 int evaluatePassedPawns(EvalInfo *ei, Board *board, int colour);
 int evaluateThreats(EvalInfo *ei, Board *board, int colour);
 int evaluateScaleFactor(Board *board);
+void evaluateMaterial(Board *board, MaterialEntry *mentry);
 void initializeEvalInfo(EvalInfo *ei, Board *board, PawnKingTable *pktable);
 
 #define MakeScore(mg, eg) ((int)((unsigned int)(eg) << 16) + (mg))
@@ -28,6 +28,7 @@
 
 int DistanceBetween[SQUARE_NB][SQUARE_NB];
 uint64_t BitsBetweenMasks[SQUARE_NB][SQUARE_NB];
+uint64_t LineMasks[SQUARE_NB][SQUARE_NB];
 uint64_t KingAreaMasks[COLOUR_NB][SQUARE_NB];
 uint64_t ForwardRanksMasks[COLOUR_NB][RANK_NB];
 uint64_t AdjacentFilesMasks[FILE_NB];
@@ -57,6 +58,18 @@ void initMasks() {
                 BitsBetweenMasks[sq1][sq2] = rookAttacks(sq1, 1ull << sq2)
                                            & rookAttacks(sq2, 1ull << sq1);
 
+    // Initialize a table of bitmasks for the full line through two given squares
+    for (int sq1 = 0; sq1 < SQUARE_NB; sq1++) {
+        for (int sq2 = 0; sq2 < SQUARE_NB; sq2++) {
+            if (testBit(bishopAttacks(sq1, 0ull), sq2))
+                LineMasks[sq1][sq2] = (bishopAttacks(sq1, 0ull) & bishopAttacks(sq2, 0ull))
+                                    | (1ull << sq1) | (1ull << sq2);
+            if (testBit(rookAttacks(sq1, 0ull), sq2))
+                LineMasks[sq1][sq2] = (rookAttacks(sq1, 0ull) & rookAttacks(sq2, 0ull))
+                                    | (1ull << sq1) | (1ull << sq2);
+        }
+    }
+
     // Initialize a table for the King Areas. Use the King's square, the King's target
     // squares, and the squares within the pawn shield. When on the A/H files, extend
     // the King Area to include an additional file, namely the C and F file respectively
@@ -121,6 +134,12 @@ uint64_t bitsBetweenMasks(int s1, int s2) {
     return BitsBetweenMasks[s1][s2];
 }
 
+uint64_t lineMasks(int s1, int s2) {
+    assert(0 <= s1 && s1 < SQUARE_NB);
+    assert(0 <= s2 && s2 < SQUARE_NB);
+    return LineMasks[s1][s2];
+}
+
 uint64_t kingAreaMasks(int colour, int sq) {
     assert(0 <= colour && colour < COLOUR_NB);
     assert(0 <= sq && sq < SQUARE_NB);
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <assert.h>
+#include <string.h>
 
 #include "bitboards.h"
 #include "board.h"
@@ -29,35 +30,34 @@
 #include "movegen.h"
 #include "psqt.h"
 #include "thread.h"
+#include "transposition.h"
 #include "types.h"
 #include "types.h"
 #include "zobrist.h"
 
-int apply(Thread *thread, Board *board, uint16_t move, int height) {
+void apply(Thread *thread, Board *board, uint16_t move, int height) {
 
-    int legal;
     Undo *undo = &thread->undoStack[height];
 
     // NULL moves are only tried when legal
     if (move == NULL_MOVE) {
         thread->moveStack[height] = NULL_MOVE;
         applyNullMove(board, undo);
-        return 1;
+        prefetchTTEntry(board->hash);
+        return;
     }
 
-    // Apply and reject the move if illegal
+    // Apply the move, and start fetching the child's table entries right
+    // away. The move generators and the Move Picker only produce legal moves
     applyMove(board, move, undo);
-    legal = isNotInCheck(board, !board->turn);
-    if (!legal) revertMove(board, move, undo);
+    prefetchTTEntry(board->hash);
+    if (board->pkhash != undo->pkhash)
+        prefetchPawnKingEntry(&thread->pktable, board->pkhash);
+    assert(isNotInCheck(board, !board->turn));
 
     // Track each move and which piece type made it throughout the tree
-    if (legal) {
-        thread->moveStack[height] = move;
-        thread->pieceStack[height] = pieceType(board->squares[MoveTo(move)]);
-    }
-
-    // Let the search know to skip this move
-    return legal;
+    thread->moveStack[height] = move;
+    thread->pieceStack[height] = pieceType(board->squares[MoveTo(move)]);
 }
 
 void applyMove(Board *board, uint16_t move, Undo *undo) {
@@ -69,7 +69,9 @@ void applyMove(Board *board, uint16_t move, Undo *undo) {
 
     undo->hash = board->hash;
     undo->pkhash = board->pkhash;
+    undo->mhash = board->mhash;
     undo->kingAttackers = board->kingAttackers;
+    undo->pinned = board->pinned;
     undo->castleRights = board->castleRights;
     undo->epSquare = board->epSquare;
     undo->fiftyMoveRule = board->fiftyMoveRule;
@@ -95,8 +97,9 @@ void applyMove(Board *board, uint16_t move, Undo *undo) {
     // No function updates this, so we do it here
     board->turn = !board->turn;
 
-    // Need king attackers to verify move legality
+    // Need king attackers and pinned pieces to generate legal moves
     board->kingAttackers = attackersToKingSquare(board);
+    board->pinned = pinnedPieces(board, board->turn);
 }
 
 void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
@@ -143,6 +146,8 @@ void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
     if (toType == PAWN || toType == KING)
         board->pkhash ^= ZobristKeys[toPiece][to];
 
+    board->mhash   -= ZobristMaterialKeys[toPiece][to];
+
     if (fromType == PAWN && (to ^ from) == 16) {
 
         const uint64_t enemyPawns =  board->pieces[PAWN]
@@ -235,6 +240,8 @@ void applyEnpassMove(Board *board, uint16_t move, Undo *undo) {
                    ^  ZobristKeys[fromPiece][to]
                    ^  ZobristKeys[enpassPiece][ep];
 
+    board->mhash   -= ZobristMaterialKeys[enpassPiece][ep];
+
     assert(pieceType(fromPiece) == PAWN);
     assert(pieceType(enpassPiece) == PAWN);
 }
@@ -279,12 +286,17 @@ void applyPromotionMove(Board *board, uint16_t move, Undo *undo) {
 
     board->pkhash  ^= ZobristKeys[fromPiece][from];
 
+    board->mhash   += ZobristMaterialKeys[promoPiece][to]
+                   -  ZobristMaterialKeys[fromPiece][from]
+                   -  ZobristMaterialKeys[toPiece][to];
+
     assert(pieceType(fromPiece) == PAWN);
 }
 
 void applyNullMove(Board *board, Undo *undo) {
 
     undo->hash = board->hash;
+    undo->pinned = board->pinned;
     undo->epSquare = board->epSquare;
     undo->fiftyMoveRule = board->fiftyMoveRule;
 
@@ -297,6 +309,9 @@ void applyNullMove(Board *board, Undo *undo) {
 
     board->epSquare = -1;
     board->fiftyMoveRule += 1;
+
+    // The other side now moves, with its own pinned pieces
+    board->pinned = pinnedPieces(board, board->turn);
 }
 
 void revert(Thread *thread, Board *board, uint16_t move, int height) {
@@ -314,7 +329,9 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
     board->numMoves--;
     board->hash = undo->hash;
     board->pkhash = undo->pkhash;
+    board->mhash = undo->mhash;
     board->kingAttackers = undo->kingAttackers;
+    board->pinned = undo->pinned;
     board->castleRights = undo->castleRights;
     board->epSquare = undo->epSquare;
     board->fiftyMoveRule = undo->fiftyMoveRule;
@@ -392,6 +409,7 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
 void revertNullMove(Board *board, Undo *undo) {
     board->hash = undo->hash;
     board->kingAttackers = 0ull;
+    board->pinned = undo->pinned;
     board->turn = !board->turn;
     board->epSquare = undo->epSquare;
     board->fiftyMoveRule = undo->fiftyMoveRule;
@@ -408,3 +426,58 @@ void moveToString(uint16_t move, char *str) {
         str[5] = '\0';
     }
 }
+
+void moveToSAN(Board *board, uint16_t move, char *str) {
+
+    int size = 0, ambiguous = 0, sameFile = 0, sameRank = 0;
+    uint16_t moves[MAX_MOVES];
+
+    const int from = MoveFrom(move), to = MoveTo(move);
+    const int type = pieceType(board->squares[from]);
+    const int capture = board->squares[to] != EMPTY || MoveType(move) == ENPASS_MOVE;
+
+    // Castling is written without any squares
+    if (MoveType(move) == CASTLE_MOVE) {
+        strcpy(str, to > from ? "O-O" : "O-O-O");
+        return;
+    }
+
+    // Find any other legal move of the same piece type to the same square
+    genAllLegalMoves(board, moves, &size);
+    for (int i = 0; i < size; i++) {
+
+        if (   moves[i] == move
+            || MoveTo(moves[i]) != to
+            || MoveType(moves[i]) == CASTLE_MOVE
+            || pieceType(board->squares[MoveFrom(moves[i])]) != type)
+            continue;
+
+        ambiguous = 1;
+        sameFile |= fileOf(MoveFrom(moves[i])) == fileOf(from);
+        sameRank |= rankOf(MoveFrom(moves[i])) == rankOf(from);
+    }
+
+    // Pawns are identified by their file, and only when capturing
+    if (type == PAWN) {
+        if (capture) *str++ = 'a' + fileOf(from);
+    }
+
+    // Pieces are disambiguated by file, then rank, and then by both
+    else {
+        *str++ = PieceLabel[WHITE][type];
+        if (ambiguous && (!sameFile || sameRank)) *str++ = 'a' + fileOf(from);
+        if (ambiguous &&   sameFile)              *str++ = '1' + rankOf(from);
+    }
+
+    if (capture) *str++ = 'x';
+
+    squareToString(to, str);
+    str += 2;
+
+    if (MoveType(move) == PROMOTION_MOVE) {
+        *str++ = '=';
+        *str++ = PieceLabel[WHITE][MovePromoPiece(move)];
+    }
+
+    *str = '\0';
+}
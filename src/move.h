@@ -41,7 +41,7 @@
 #define ROOK_PROMO_MOVE   (PROMOTION_MOVE | PROMOTE_TO_ROOK  )
 #define QUEEN_PROMO_MOVE  (PROMOTION_MOVE | PROMOTE_TO_QUEEN )
 
-int apply(Thread *thread, Board *board, uint16_t move, int height);
+void apply(Thread *thread, Board *board, uint16_t move, int height);
 void applyMove(Board* board, uint16_t move, Undo* undo);
 void applyNormalMove(Board* board, uint16_t move, Undo* undo);
 void applyCastleMove(Board* board, uint16_t move, Undo* undo);
@@ -54,6 +54,7 @@ void revertMove(Board* board, uint16_t move, Undo* undo);
 void revertNullMove(Board* board, Undo* undo);
 
 void moveToString(uint16_t move, char *str);
+void moveToSAN(Board *board, uint16_t move, char *str);
 
 #define MoveFrom(move)         (((move) >> 0) & 63)
 #define MoveTo(move)           (((move) >> 6) & 63)
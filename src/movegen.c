@@ -56,10 +56,11 @@ uint64_t pawnEnpassCaptures(uint64_t pawns, int epsq, int colour){
 
 /* For Building Actual Move Lists For Each Piece Type */
 
-void buildEnpassMoves(uint16_t* moves, int* size, uint64_t attacks, int epsq){
+void buildEnpassMoves(Board* board, uint16_t* moves, int* size, uint64_t attacks, int epsq){
     while (attacks){
         int sq = poplsb(&attacks);
-        moves[(*size)++] = MoveMake(sq, epsq, ENPASS_MOVE);
+        if (moveIsLegal(board, MoveMake(sq, epsq, ENPASS_MOVE)))
+            moves[(*size)++] = MoveMake(sq, epsq, ENPASS_MOVE);
     }
 }
 
@@ -80,6 +81,48 @@ void buildPawnPromotions(uint16_t* moves, int* size, uint64_t attacks, int delta
     }
 }
 
+void buildPawnNoisyMoves(Board* board, uint16_t* moves, int* size, uint64_t pawns, uint64_t targets){
+
+    const int forwardShift = board->turn == WHITE ? -8 : 8;
+    const int leftShift    = board->turn == WHITE ? -7 : 7;
+    const int rightShift   = board->turn == WHITE ? -9 : 9;
+
+    uint64_t enemy    = board->colours[!board->turn];
+    uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+
+    // Compute bitboards for each type of pawn movement
+    uint64_t pawnLeft         = pawnLeftAttacks(pawns, enemy & targets, board->turn);
+    uint64_t pawnRight        = pawnRightAttacks(pawns, enemy & targets, board->turn);
+    uint64_t pawnPromoForward = pawnAdvance(pawns, occupied, board->turn) & PROMOTION_RANKS & targets;
+    uint64_t pawnPromoLeft    = pawnLeft & PROMOTION_RANKS; pawnLeft &= ~PROMOTION_RANKS;
+    uint64_t pawnPromoRight   = pawnRight & PROMOTION_RANKS; pawnRight &= ~PROMOTION_RANKS;
+
+    // Generate all pawn captures that are not promotions
+    buildPawnMoves(moves, size, pawnLeft, leftShift);
+    buildPawnMoves(moves, size, pawnRight, rightShift);
+
+    // Generate all pawn promotions
+    buildPawnPromotions(moves, size, pawnPromoForward, forwardShift);
+    buildPawnPromotions(moves, size, pawnPromoLeft, leftShift);
+    buildPawnPromotions(moves, size, pawnPromoRight, rightShift);
+}
+
+void buildPawnQuietMoves(Board* board, uint16_t* moves, int* size, uint64_t pawns, uint64_t targets){
+
+    const uint64_t rank3Rel = board->turn == WHITE ? RANK_3 : RANK_6;
+    const int forwardShift  = board->turn == WHITE ?     -8 :      8;
+
+    uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+
+    // Compute bitboards for the pawn advances
+    uint64_t pawnForwardOne = pawnAdvance(pawns, occupied, board->turn) & ~PROMOTION_RANKS;
+    uint64_t pawnForwardTwo = pawnAdvance(pawnForwardOne & rank3Rel, occupied, board->turn);
+
+    // Generate all of the pawn advances
+    buildPawnMoves(moves, size, pawnForwardOne & targets, forwardShift);
+    buildPawnMoves(moves, size, pawnForwardTwo & targets, forwardShift * 2);
+}
+
 void buildNonPawnMoves(uint16_t* moves, int* size, uint64_t attacks, int sq){
     while (attacks){
         int tg = poplsb(&attacks);
@@ -94,23 +137,30 @@ void buildKnightMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t targ
     }
 }
 
-void buildBishopAndQueenMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t occupied, uint64_t targets){
+void buildBishopAndQueenMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t occupied, uint64_t targets, uint64_t pinned, int king){
     while (pieces){
         int sq = poplsb(&pieces);
-        buildNonPawnMoves(moves, size, bishopAttacks(sq, occupied) & targets, sq);
+        uint64_t line = testBit(pinned, sq) ? lineMasks(king, sq) : ~0ull;
+        buildNonPawnMoves(moves, size, bishopAttacks(sq, occupied) & targets & line, sq);
     }
 }
 
-void buildRookAndQueenMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t occupied, uint64_t targets){
+void buildRookAndQueenMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t occupied, uint64_t targets, uint64_t pinned, int king){
     while (pieces){
         int sq = poplsb(&pieces);
-        buildNonPawnMoves(moves, size, rookAttacks(sq, occupied) & targets, sq);
+        uint64_t line = testBit(pinned, sq) ? lineMasks(king, sq) : ~0ull;
+        buildNonPawnMoves(moves, size, rookAttacks(sq, occupied) & targets & line, sq);
     }
 }
 
-void buildKingMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t targets){
+void buildKingMoves(Board* board, uint16_t* moves, int* size, uint64_t pieces, uint64_t targets){
     int sq = getlsb(pieces);
-    buildNonPawnMoves(moves, size, kingAttacks(sq) & targets, sq);
+    uint64_t attacks = kingAttacks(sq) & targets;
+    while (attacks){
+        int tg = poplsb(&attacks);
+        if (moveIsLegal(board, MoveMake(sq, tg, NORMAL_MOVE)))
+            moves[(*size)++] = MoveMake(sq, tg, NORMAL_MOVE);
+    }
 }
 
 
@@ -118,24 +168,14 @@ void buildKingMoves(uint16_t* moves, int* size, uint64_t pieces, uint64_t target
 
 void genAllLegalMoves(Board* board, uint16_t* moves, int* size){
 
-    Undo undo[1];
-    int i, psuedoSize = 0;
-    uint16_t psuedoMoves[MAX_MOVES];
-
-    genAllMoves(board, psuedoMoves, &psuedoSize);
+    int noisy = 0, quiet = 0;
 
-    // Check each move for legality before copying
-    for (i = 0; i < psuedoSize; i++){
-        applyMove(board, psuedoMoves[i], undo);
-        if (isNotInCheck(board, !board->turn))
-            moves[(*size)++] = psuedoMoves[i];
-        revertMove(board, psuedoMoves[i], undo);
+    // Use the dedicated generator when in check
+    if (board->kingAttackers){
+        *size = 0;
+        genEvasions(board, moves, size);
+        return;
     }
-}
-
-void genAllMoves(Board* board, uint16_t* moves, int* size){
-
-    int noisy = 0, quiet = 0;
 
     genAllNoisyMoves(board, moves, &noisy);
 
@@ -146,23 +186,12 @@ void genAllMoves(Board* board, uint16_t* moves, int* size){
 
 void genAllNoisyMoves(Board* board, uint16_t* moves, int* size){
 
-    const int forwardShift = board->turn == WHITE ? -8 : 8;
-    const int leftShift    = board->turn == WHITE ? -7 : 7;
-    const int rightShift   = board->turn == WHITE ? -9 : 9;
-
-    uint64_t destinations;
-    uint64_t pawnEnpass;
-    uint64_t pawnLeft;
-    uint64_t pawnRight;
-    uint64_t pawnPromoForward;
-    uint64_t pawnPromoLeft;
-    uint64_t pawnPromoRight;
+    uint64_t destinations, evasions;
 
     uint64_t friendly = board->colours[board->turn];
     uint64_t enemy    = board->colours[!board->turn];
-
-    uint64_t empty    = ~(friendly | enemy);
-    uint64_t occupied = ~empty;
+    uint64_t occupied = friendly | enemy;
+    uint64_t pinned   = board->pinned;
 
     uint64_t myPawns   = friendly &  board->pieces[PAWN];
     uint64_t myKnights = friendly &  board->pieces[KNIGHT];
@@ -170,68 +199,56 @@ void genAllNoisyMoves(Board* board, uint16_t* moves, int* size){
     uint64_t myRooks   = friendly & (board->pieces[ROOK]   | board->pieces[QUEEN]);
     uint64_t myKings   = friendly &  board->pieces[KING];
 
+    const int king = getlsb(myKings);
+
     // If there are two threats to the king, the only moves
     // which could be legal are captures made by the king
     if (several(board->kingAttackers)){
-        buildKingMoves(moves, size, myKings, enemy);
+        buildKingMoves(board, moves, size, myKings, enemy);
         return;
     }
 
-    // If there is one threat to the king and we are only looking for
-    // noisy moves, then the only moves possible are captures of the
-    // attacking piece, blocking the attacking piece via promotion,
-    // and blocking the attacking piece via enpass. Therefore, we will
-    // always generate all of the promotion and enpass moves
+    // If there is one threat to the king, any move other than a king move
+    // must either capture the attacking piece, or block it. Captures and
+    // promotions may do so, and enpass moves are verified separately
     else if (board->kingAttackers)
-        destinations = board->kingAttackers;
+        evasions = board->kingAttackers | bitsBetweenMasks(king, getlsb(board->kingAttackers));
 
     // No threats to the king, so any target square with an enemy piece,
     // or a move which is already noisy, is permitted in this position
     else
-        destinations = enemy;
-
-    // Compute bitboards for each type of pawn movement
-    pawnEnpass       = pawnEnpassCaptures(myPawns, board->epSquare, board->turn);
-    pawnLeft         = pawnLeftAttacks(myPawns, enemy, board->turn);
-    pawnRight        = pawnRightAttacks(myPawns, enemy, board->turn);
-    pawnPromoForward = pawnAdvance(myPawns, occupied, board->turn) & PROMOTION_RANKS;
-    pawnPromoLeft    = pawnLeft & PROMOTION_RANKS; pawnLeft &= ~PROMOTION_RANKS;
-    pawnPromoRight   = pawnRight & PROMOTION_RANKS; pawnRight &= ~PROMOTION_RANKS;
+        evasions = ~0ull;
 
-    // Generate all enpassant captures
-    buildEnpassMoves(moves, size, pawnEnpass, board->epSquare);
+    destinations = enemy & evasions;
 
-    // Generate all pawn captures that are not promotions
-    buildPawnMoves(moves, size, pawnLeft & destinations, leftShift);
-    buildPawnMoves(moves, size, pawnRight & destinations, rightShift);
+    // Generate all enpassant captures, each checked to not expose the king
+    buildEnpassMoves(board, moves, size, pawnEnpassCaptures(myPawns, board->epSquare, board->turn), board->epSquare);
 
-    // Generate all pawn promotions
-    buildPawnPromotions(moves, size, pawnPromoForward, forwardShift);
-    buildPawnPromotions(moves, size, pawnPromoLeft, leftShift);
-    buildPawnPromotions(moves, size, pawnPromoRight, rightShift);
+    // Generate pawn captures and promotions. Pinned pawns may only
+    // move along the line with their king, and so are done one at a time
+    buildPawnNoisyMoves(board, moves, size, myPawns & ~pinned, evasions);
+    for (uint64_t pawns = myPawns & pinned; pawns; ){
+        int sq = poplsb(&pawns);
+        buildPawnNoisyMoves(board, moves, size, 1ull << sq, evasions & lineMasks(king, sq));
+    }
 
-    // Generate attacks for all non pawn pieces
-    buildKnightMoves(moves, size, myKnights, destinations);
-    buildBishopAndQueenMoves(moves, size, myBishops, occupied, destinations);
-    buildRookAndQueenMoves(moves, size, myRooks, occupied, destinations);
-    buildKingMoves(moves, size, myKings, enemy);
+    // Generate attacks for all non pawn pieces. Pinned knights can never move
+    buildKnightMoves(moves, size, myKnights & ~pinned, destinations);
+    buildBishopAndQueenMoves(moves, size, myBishops, occupied, destinations, pinned, king);
+    buildRookAndQueenMoves(moves, size, myRooks, occupied, destinations, pinned, king);
+    buildKingMoves(board, moves, size, myKings, enemy);
 }
 
 void genAllQuietMoves(Board* board, uint16_t* moves, int* size){
 
-    const uint64_t rank3Rel = board->turn == WHITE ? RANK_3 : RANK_6;
-    const int forwardShift  = board->turn == WHITE ?     -8 :      8;
-
     uint64_t destinations;
 
-    uint64_t pawnForwardOne;
-    uint64_t pawnForwardTwo;
-
     uint64_t friendly = board->colours[board->turn];
-    uint64_t enemy = board->colours[!board->turn];
+    uint64_t enemy    = board->colours[!board->turn];
 
     uint64_t empty    = ~(friendly | enemy);
     uint64_t occupied = ~empty;
+    uint64_t pinned   = board->pinned;
 
     uint64_t myPawns   = friendly &  board->pieces[PAWN];
     uint64_t myKnights = friendly &  board->pieces[KNIGHT];
@@ -239,10 +256,12 @@ void genAllQuietMoves(Board* board, uint16_t* moves, int* size){
     uint64_t myRooks   = friendly & (board->pieces[ROOK]   | board->pieces[QUEEN]);
     uint64_t myKings   = friendly &  board->pieces[KING];
 
+    const int king = getlsb(myKings);
+
     // If there are two threats to the king, the only moves which
     // could be legal are moves made by the king, except castling
     if (several(board->kingAttackers)){
-        buildKingMoves(moves, size, myKings, empty);
+        buildKingMoves(board, moves, size, myKings, empty);
         return;
     }
 
@@ -253,14 +272,14 @@ void genAllQuietMoves(Board* board, uint16_t* moves, int* size){
         // or capturing the pawn / knight will be legal. However, here we are
         // only generating quiet moves, thus we must move the king
         if (board->kingAttackers & (board->pieces[PAWN] | board->pieces[KNIGHT])){
-            buildKingMoves(moves, size, myKings, empty);
+            buildKingMoves(board, moves, size, myKings, empty);
             return;
         }
 
         // The attacker is a sliding piece, therefore we can either block the attack
         // by moving a piece infront of the attacking path if the slider, or we can
         // again simple move our king (Castling excluded, of course)
-        destinations = empty & bitsBetweenMasks(getlsb(myKings), getlsb(board->kingAttackers));
+        destinations = empty & bitsBetweenMasks(king, getlsb(board->kingAttackers));
     }
 
     // We are not being attacked, and therefore will look at any quiet move,
@@ -269,31 +288,34 @@ void genAllQuietMoves(Board* board, uint16_t* moves, int* size){
     else
         destinations = empty;
 
-    // Compute bitboards for the pawn advances
-    pawnForwardOne = pawnAdvance(myPawns, occupied, board->turn) & ~PROMOTION_RANKS;
-    pawnForwardTwo = pawnAdvance(pawnForwardOne & rank3Rel, occupied, board->turn);
-
-    // Generate all of the pawn advances
-    buildPawnMoves(moves, size, pawnForwardOne & destinations, forwardShift);
-    buildPawnMoves(moves, size, pawnForwardTwo & destinations, forwardShift * 2);
+    // Generate all of the pawn advances. Pinned pawns may only
+    // move along the line with their king, and so are done one at a time
+    buildPawnQuietMoves(board, moves, size, myPawns & ~pinned, destinations);
+    for (uint64_t pawns = myPawns & pinned; pawns; ){
+        int sq = poplsb(&pawns);
+        buildPawnQuietMoves(board, moves, size, 1ull << sq, destinations & lineMasks(king, sq));
+    }
 
     // Generate all moves for all non pawns aside from Castles
-    buildKnightMoves(moves, size, myKnights, destinations);
-    buildBishopAndQueenMoves(moves, size, myBishops, occupied, destinations);
-    buildRookAndQueenMoves(moves, size, myRooks, occupied, destinations);
-    buildKingMoves(moves, size, myKings, empty);
+    buildKnightMoves(moves, size, myKnights & ~pinned, destinations);
+    buildBishopAndQueenMoves(moves, size, myBishops, occupied, destinations, pinned, king);
+    buildRookAndQueenMoves(moves, size, myRooks, occupied, destinations, pinned, king);
+    buildKingMoves(board, moves, size, myKings, empty);
 
-    // Generate all the castling moves
+    // Generate all the castling moves. The king may not pass
+    // through, nor land upon, a square which is under attack
     if (board->turn == WHITE && !board->kingAttackers){
 
         if (  ((occupied & WHITE_CASTLE_KING_SIDE_MAP) == 0)
             && (board->castleRights & WHITE_KING_RIGHTS)
-            && !squareIsAttacked(board, WHITE, 5))
+            && !squareIsAttacked(board, WHITE, 5)
+            && !squareIsAttacked(board, WHITE, 6))
             moves[(*size)++] = MoveMake(4, 6, CASTLE_MOVE);
 
         if (  ((occupied & WHITE_CASTLE_QUEEN_SIDE_MAP) == 0)
             && (board->castleRights & WHITE_QUEEN_RIGHTS)
-            && !squareIsAttacked(board, WHITE, 3))
+            && !squareIsAttacked(board, WHITE, 3)
+            && !squareIsAttacked(board, WHITE, 2))
             moves[(*size)++] = MoveMake(4, 2, CASTLE_MOVE);
     }
 
@@ -301,16 +323,210 @@ void genAllQuietMoves(Board* board, uint16_t* moves, int* size){
 
         if (  ((occupied & BLACK_CASTLE_KING_SIDE_MAP) == 0)
             && (board->castleRights & BLACK_KING_RIGHTS)
-            && !squareIsAttacked(board, BLACK, 61))
+            && !squareIsAttacked(board, BLACK, 61)
+            && !squareIsAttacked(board, BLACK, 62))
             moves[(*size)++] = MoveMake(60, 62, CASTLE_MOVE);
 
         if (  ((occupied & BLACK_CASTLE_QUEEN_SIDE_MAP) == 0)
             && (board->castleRights & BLACK_QUEEN_RIGHTS)
-            && !squareIsAttacked(board, BLACK, 59))
+            && !squareIsAttacked(board, BLACK, 59)
+            && !squareIsAttacked(board, BLACK, 58))
             moves[(*size)++] = MoveMake(60, 58, CASTLE_MOVE);
     }
 }
 
+void genEvasions(Board* board, uint16_t* moves, int* size){
+
+    uint64_t evasions;
+
+    uint64_t friendly = board->colours[board->turn];
+    uint64_t enemy    = board->colours[!board->turn];
+    uint64_t occupied = friendly | enemy;
+
+    // A pinned piece can neither capture the attacking piece, nor block
+    // it, since it may not leave the line between its king and the pinner
+    uint64_t movable  = friendly & ~board->pinned;
+
+    uint64_t myPawns   = movable  &  board->pieces[PAWN];
+    uint64_t myKnights = movable  &  board->pieces[KNIGHT];
+    uint64_t myBishops = movable  & (board->pieces[BISHOP] | board->pieces[QUEEN]);
+    uint64_t myRooks   = movable  & (board->pieces[ROOK]   | board->pieces[QUEEN]);
+    uint64_t myKings   = friendly &  board->pieces[KING];
+
+    const int king = getlsb(myKings);
+
+    assert(board->kingAttackers);
+
+    // The king may always try to step aside, or capture an attacker
+    buildKingMoves(board, moves, size, myKings, ~friendly);
+
+    // If there are two threats to the king, only the king may move
+    if (several(board->kingAttackers))
+        return;
+
+    // Otherwise the other pieces must capture the attacker or interpose
+    evasions = board->kingAttackers | bitsBetweenMasks(king, getlsb(board->kingAttackers));
+
+    // Enpass captures may remove a checking pawn, and are verified separately
+    buildEnpassMoves(board, moves, size, pawnEnpassCaptures(myPawns, board->epSquare, board->turn), board->epSquare);
+
+    // Generate pawn captures, promotions, and advances onto the evasion squares
+    buildPawnNoisyMoves(board, moves, size, myPawns, evasions);
+    buildPawnQuietMoves(board, moves, size, myPawns, evasions);
+
+    // Generate captures and interpositions for all non pawn pieces
+    buildKnightMoves(moves, size, myKnights, evasions);
+    buildBishopAndQueenMoves(moves, size, myBishops, occupied, evasions, 0ull, king);
+    buildRookAndQueenMoves(moves, size, myRooks, occupied, evasions, 0ull, king);
+}
+
+int moveIsLegal(Board* board, uint16_t move){
+
+    const int from = MoveFrom(move);
+    const int to   = MoveTo(move);
+
+    uint64_t enemy    = board->colours[!board->turn];
+    uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+    uint64_t myKings  = board->colours[board->turn] & board->pieces[KING];
+
+    const int king = getlsb(myKings);
+
+    // Enpass moves remove two pieces from the board at once, which can
+    // expose the king along a rank, so verify them with the final occupancy
+    if (MoveType(move) == ENPASS_MOVE){
+        const int captured = to + (board->turn == WHITE ? -8 : 8);
+        occupied ^= (1ull << from) ^ (1ull << captured) ^ (1ull << to);
+        return !(allAttackersToSquare(board, occupied, king) & enemy & ~(1ull << captured));
+    }
+
+    // Castles have already had their path verified, aside from the destination
+    if (MoveType(move) == CASTLE_MOVE)
+        return !squareIsAttacked(board, board->turn, to);
+
+    // The king may not move to an attacked square, including squares
+    // which are only attacked through the king's current square
+    if (from == king)
+        return !(allAttackersToSquare(board, occupied ^ myKings, to) & enemy);
+
+    // Only king moves can escape from two threats at once
+    if (several(board->kingAttackers))
+        return 0;
+
+    // With one threat, we must capture the attacking piece or block it
+    if (   board->kingAttackers
+        && !testBit(board->kingAttackers | bitsBetweenMasks(king, getlsb(board->kingAttackers)), to))
+        return 0;
+
+    // Pinned pieces may only move along the line with their king
+    return !testBit(board->pinned, from) || testBit(lineMasks(king, from), to);
+}
+
+uint64_t pinnedPieces(Board* board, int colour){
+
+    uint64_t friendly = board->colours[ colour];
+    uint64_t enemy    = board->colours[!colour];
+
+    const int king = getlsb(friendly & board->pieces[KING]);
+
+    // A piece is pinned when it alone blocks an enemy slider from our king
+    return sliderBlockers(board, enemy, king) & friendly;
+}
+
+uint64_t sliderBlockers(Board* board, uint64_t sliders, int sq){
+
+    uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+    uint64_t bishops  = sliders & (board->pieces[BISHOP] | board->pieces[QUEEN]);
+    uint64_t rooks    = sliders & (board->pieces[ROOK  ] | board->pieces[QUEEN]);
+
+    uint64_t blockers = 0ull, between;
+
+    // Find the sliders which would attack the square on an empty board
+    uint64_t snipers = (bishopAttacks(sq, 0ull) & bishops)
+                     | (rookAttacks(sq, 0ull) & rooks);
+
+    // Collect each piece which stands alone between a slider and the square
+    while (snipers){
+        between = bitsBetweenMasks(sq, poplsb(&snipers)) & occupied;
+        if (onlyOne(between)) blockers |= between;
+    }
+
+    return blockers;
+}
+
+void initCheckInfo(Board* board, CheckInfo* ci){
+
+    uint64_t friendly = board->colours[ board->turn];
+    uint64_t enemy    = board->colours[!board->turn];
+    uint64_t occupied = friendly | enemy;
+
+    ci->king = getlsb(enemy & board->pieces[KING]);
+
+    // Squares from which each of our pieces would attack the enemy king
+    ci->squares[PAWN  ] = pawnAttacks(!board->turn, ci->king);
+    ci->squares[KNIGHT] = knightAttacks(ci->king);
+    ci->squares[BISHOP] = bishopAttacks(ci->king, occupied);
+    ci->squares[ROOK  ] = rookAttacks(ci->king, occupied);
+    ci->squares[QUEEN ] = ci->squares[BISHOP] | ci->squares[ROOK];
+    ci->squares[KING  ] = 0ull;
+
+    // Our pieces which alone block one of our sliders from the enemy king
+    ci->discovers = sliderBlockers(board, friendly, ci->king) & friendly;
+}
+
+int moveGivesCheck(Board* board, uint16_t move, CheckInfo* ci){
+
+    const int from = MoveFrom(move);
+    const int to   = MoveTo(move);
+
+    const int rookFrom = to > from ? to + 1 : to - 2; // Only for castling
+    const int rookTo   = to > from ? to - 1 : to + 1; // Only for castling
+
+    uint64_t friendly = board->colours[board->turn];
+    uint64_t occupied = friendly | board->colours[!board->turn];
+    uint64_t bishops  = friendly & (board->pieces[BISHOP] | board->pieces[QUEEN]);
+    uint64_t rooks    = friendly & (board->pieces[ROOK  ] | board->pieces[QUEEN]);
+
+    // The moving piece attacks the king directly from its new square
+    if (   MoveType(move) != PROMOTION_MOVE
+        && testBit(ci->squares[pieceType(board->squares[from])], to))
+        return 1;
+
+    // The moving piece uncovers an attack, by leaving the line with the king
+    if (testBit(ci->discovers, from) && !testBit(lineMasks(ci->king, from), to))
+        return 1;
+
+    switch (MoveType(move)){
+
+    case NORMAL_MOVE:
+        return 0;
+
+    // The promoted piece may attack through the square the pawn left
+    case PROMOTION_MOVE:
+        occupied ^= 1ull << from;
+        return MovePromoPiece(move) == KNIGHT ? testBit(knightAttacks(to), ci->king)
+             : MovePromoPiece(move) == BISHOP ? testBit(bishopAttacks(to, occupied), ci->king)
+             : MovePromoPiece(move) == ROOK   ? testBit(rookAttacks(to, occupied), ci->king)
+             :                                  testBit(queenAttacks(to, occupied), ci->king);
+
+    // Enpass removes two pieces from a line, so look again at our sliders
+    case ENPASS_MOVE:
+        occupied ^= (1ull << from) ^ (1ull << (to + (board->turn == WHITE ? -8 : 8))) ^ (1ull << to);
+        return !!(   (bishopAttacks(ci->king, occupied) & bishops)
+                  || (rookAttacks(ci->king, occupied) & rooks));
+
+    // Castling moves both the king and a rook, so look again at our sliders
+    case CASTLE_MOVE:
+        rooks    ^= (1ull << rookFrom) ^ (1ull << rookTo);
+        occupied ^= (1ull << from) ^ (1ull << to) ^ (1ull << rookFrom) ^ (1ull << rookTo);
+        return !!(   (bishopAttacks(ci->king, occupied) & bishops)
+                  || (rookAttacks(ci->king, occupied) & rooks));
+
+    default:
+        assert(0);
+        return 0;
+    }
+}
+
 int isNotInCheck(Board* board, int colour){
     int kingsq = getlsb(board->colours[colour] & board->pieces[KING]);
     assert(board->squares[kingsq] == WHITE_KING + colour);
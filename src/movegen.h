@@ -23,6 +23,12 @@
 
 #include "types.h"
 
+struct CheckInfo {
+    int king;                   // Square of the enemy king
+    uint64_t squares[PIECE_NB]; // Squares from which each piece type gives check
+    uint64_t discovers;         // Our pieces which would discover a check by moving
+};
+
 uint64_t pawnLeftAttacks(uint64_t pawns, uint64_t targets, int colour);
 uint64_t pawnRightAttacks(uint64_t pawns, uint64_t targets, int colour);
 uint64_t pawnAttackSpan(uint64_t pawns, uint64_t targets, int colour);
@@ -30,9 +36,16 @@ uint64_t pawnAdvance(uint64_t pawns, uint64_t occupied, int colour);
 uint64_t pawnEnpassCaptures(uint64_t pawns, int epsq, int colour);
 
 void genAllLegalMoves(Board* board, uint16_t* moves, int* size);
-void genAllMoves(Board* board, uint16_t* moves, int* size);
 void genAllNoisyMoves(Board* board, uint16_t* moves, int* size);
 void genAllQuietMoves(Board* board, uint16_t* moves, int* size);
+void genEvasions(Board* board, uint16_t* moves, int* size);
+
+int moveIsLegal(Board* board, uint16_t move);
+uint64_t pinnedPieces(Board* board, int colour);
+uint64_t sliderBlockers(Board* board, uint64_t sliders, int sq);
+
+void initCheckInfo(Board* board, CheckInfo* ci);
+int moveGivesCheck(Board* board, uint16_t move, CheckInfo* ci);
 
 int isNotInCheck(Board* board, int colour);
 int squareIsAttacked(Board* board, int colour, int sq);
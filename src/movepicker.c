@@ -29,6 +29,7 @@
 #include "movegen.h"
 #include "movepicker.h"
 #include "psqt.h"
+#include "transposition.h"
 #include "types.h"
 #include "thread.h"
 
@@ -43,10 +44,11 @@ void initMovePicker(MovePicker* mp, Thread* thread, uint16_t ttMove, int height)
 
     // Threshold for good noisy
     mp->threshold = 0;
+    mp->split = 0;
 
     mp->thread = thread;
     mp->height = height;
-    mp->type = NORMAL_PICKER;
+    mp->type = thread->board.kingAttackers ? EVASION_PICKER : NORMAL_PICKER;
 }
 
 void initNoisyMovePicker(MovePicker* mp, Thread* thread, int threshold){
@@ -70,197 +72,165 @@ void initNoisyMovePicker(MovePicker* mp, Thread* thread, int threshold){
 
 uint16_t selectNextMove(MovePicker* mp, Board* board, int skipQuiets){
 
-    int best;
-    uint16_t bestMove;
+    int size = 0;
+    uint16_t move, moves[MAX_MOVES];
 
-    switch (mp->stage){
+    while (1) switch (mp->stage){
 
     case STAGE_TABLE:
 
-        // Play table move if it is psuedo legal
+        // Play table move if it is legal
         mp->stage = STAGE_GENERATE_NOISY;
-        if (moveIsPsuedoLegal(board, mp->tableMove))
+        if (moveIsPsuedoLegal(board, mp->tableMove) && moveIsLegal(board, mp->tableMove))
             return mp->tableMove;
 
-        /* fallthrough */
+        // Otherwise the entry likely belonged to another position
+        if (mp->tableMove != NONE_MOVE)
+            TTStat(&mp->thread->ttstats, falseMatches);
+
+        continue;
 
     case STAGE_GENERATE_NOISY:
 
-        // Generate and evaluate noisy moves. mp->split tracks the
-        // break point between noisy and quiets, which allows us
-        // to use a BAD_NOISY stage, where we skip noisy moves which
-        // fail a simple SEE, and try them after all quiet moves
+        // Generate and evaluate noisy moves, to be selected by MVV-LVA. Moves
+        // which fail a simple SEE are moved to the front of the list as they
+        // are passed over, for use in the BAD_NOISY stage after all quiets
+        mp->cur = mp->bad = 0;
+
+        // When in check, generate every evasion at once. The noisy evasions
+        // are placed first, and the quiets are kept unscored after them
+        if (mp->type == EVASION_PICKER){
+            genEvasions(board, moves, &size);
+            mp->split = partitionEvasions(board, moves, size);
+            for (int i = mp->split; i < size; i++)
+                mp->entries[i] = MoveEntry(moves[i], 0);
+        }
 
-        mp->noisySize = 0;
-        genAllNoisyMoves(board, mp->moves, &mp->noisySize);
-        evaluateNoisyMoves(mp);
-        mp->split = mp->noisySize;
+        else {
+            genAllNoisyMoves(board, moves, &size);
+            mp->split = size;
+        }
+
+        evaluateNoisyMoves(mp, moves, 0, mp->split);
+        mp->end = size;
         mp->stage = STAGE_GOOD_NOISY;
 
         /* fallthrough */
 
     case STAGE_GOOD_NOISY:
 
-        // Check to see if there are still more noisy moves
-        if (mp->noisySize != 0){
-
-            // Select next best MVV-LVA from the noisy moves
-            best = getBestMoveIndex(mp, 0, mp->noisySize);
-            bestMove = mp->moves[best];
-
-            // Values below zero are flagged as failing an SEE (bad noisy)
-            if (mp->values[best] >= 0) {
+        // Play the remaining noisy moves in order, while they pass SEE
+        while (mp->cur < mp->split){
 
-                // Skip bad noisy moves during this stage
-                if (!staticExchangeEvaluation(board, bestMove, mp->threshold)){
+            int32_t entry = selectBestEntry(mp->entries, mp->cur++, mp->split);
+            move = EntryMove(entry);
 
-                    // Flag for failed use in STAGE_BAD_NOISY
-                    mp->values[best] = -1;
+            // Don't play the table move twice
+            if (move == mp->tableMove)
+                continue;
 
-                    // Try again to find a noisy move passing SEE
-                    return selectNextMove(mp, board, skipQuiets);
-                }
-
-                // Reduce effective move list size
-                mp->noisySize -= 1;
-                mp->moves[best] = mp->moves[mp->noisySize];
-                mp->values[best] = mp->values[mp->noisySize];
-
-                // Don't play the table move twice
-                if (bestMove == mp->tableMove)
-                    return selectNextMove(mp, board, skipQuiets);
+            // Save moves failing SEE for the BAD_NOISY stage
+            if (!staticExchangeEvaluation(board, move, mp->threshold)){
+                mp->entries[mp->bad++] = entry;
+                continue;
+            }
 
-                // Don't play the special moves twice
-                if (bestMove == mp->killer1) mp->killer1 = NONE_MOVE;
-                if (bestMove == mp->killer2) mp->killer2 = NONE_MOVE;
-                if (bestMove == mp->counter) mp->counter = NONE_MOVE;
+            // Don't play the special moves twice
+            if (move == mp->killer1) mp->killer1 = NONE_MOVE;
+            if (move == mp->killer2) mp->killer2 = NONE_MOVE;
+            if (move == mp->counter) mp->counter = NONE_MOVE;
 
-                return bestMove;
-            }
+            return move;
         }
 
         // Jump to bad noisy moves when skipping quiets
-        if (skipQuiets){
-            mp->stage = STAGE_BAD_NOISY;
-            return selectNextMove(mp, board, skipQuiets);
-        }
-
-        mp->stage = STAGE_KILLER_1;
+        mp->stage = skipQuiets ? STAGE_BAD_NOISY : STAGE_KILLER_1;
+        mp->cur = 0;
+        if (skipQuiets) continue;
 
         /* fallthrough */
 
     case STAGE_KILLER_1:
 
-        // Play killer move if not yet played, and psuedo legal
+        // Play killer move if not yet played, and legal
         mp->stage = STAGE_KILLER_2;
         if (   !skipQuiets
             &&  mp->killer1 != mp->tableMove
-            &&  moveIsPsuedoLegal(board, mp->killer1))
+            &&  moveIsPsuedoLegal(board, mp->killer1)
+            &&  moveIsLegal(board, mp->killer1))
             return mp->killer1;
 
         /* fallthrough */
 
     case STAGE_KILLER_2:
 
-        // Play killer move if not yet played, and psuedo legal
+        // Play killer move if not yet played, and legal
         mp->stage = STAGE_COUNTER_MOVE;
         if (   !skipQuiets
             &&  mp->killer2 != mp->tableMove
-            &&  moveIsPsuedoLegal(board, mp->killer2))
+            &&  moveIsPsuedoLegal(board, mp->killer2)
+            &&  moveIsLegal(board, mp->killer2))
             return mp->killer2;
 
         /* fallthrough */
 
     case STAGE_COUNTER_MOVE:
 
-        // Play counter move if not yet played, and psuedo legal
+        // Play counter move if not yet played, and legal
         mp->stage = STAGE_GENERATE_QUIET;
         if (   !skipQuiets
             &&  mp->counter != mp->tableMove
             &&  mp->counter != mp->killer1
             &&  mp->counter != mp->killer2
-            &&  moveIsPsuedoLegal(board, mp->counter))
+            &&  moveIsPsuedoLegal(board, mp->counter)
+            &&  moveIsLegal(board, mp->counter))
             return mp->counter;
 
         /* fallthrough */
 
     case STAGE_GENERATE_QUIET:
 
-        // Generate and evaluate all quiet moves when not skipping quiet moves
+        // Generate and evaluate all quiet moves when not skipping quiet
+        // moves. They are selected by history only as they are requested,
+        // so quiets which are pruned away are never ordered. We may have
+        // fallen through from the noisy stages, so reuse the buffer. When
+        // in check, the quiet evasions were generated with the noisy ones
         if (!skipQuiets){
-            mp->quietSize = 0;
-            genAllQuietMoves(board, mp->moves + mp->split, &mp->quietSize);
-            getHistoryScores(mp->thread, mp->moves, mp->values, mp->split, mp->quietSize, mp->height);
+            size = 0;
+            if (mp->type == EVASION_PICKER)
+                for (; mp->split + size < mp->end; size++)
+                    moves[size] = EntryMove(mp->entries[mp->split + size]);
+            else genAllQuietMoves(board, moves, &size);
+            evaluateQuietMoves(mp, moves, mp->split, size);
         }
 
+        mp->cur = mp->split;
+        mp->end = mp->split + (skipQuiets ? 0 : size);
         mp->stage = STAGE_QUIET;
 
         /* fallthrough */
 
     case STAGE_QUIET:
 
-        // Check to see if there are still more quiet moves
-        if (!skipQuiets && mp->quietSize){
+        // Play the remaining quiet moves in order, unless skipping quiets
+        if (!skipQuiets && (move = nextListMove(mp, mp->end)) != NONE_MOVE)
+            return move;
 
-            // Select next best quiet by history scores
-            best = getBestMoveIndex(mp, mp->split, mp->split + mp->quietSize);
-
-            // Save the best move before overwriting it
-            bestMove = mp->moves[best];
-
-            // Reduce effective move list size
-            mp->quietSize--;
-            mp->moves[best] = mp->moves[mp->split + mp->quietSize];
-            mp->values[best] = mp->values[mp->split + mp->quietSize];
-
-            // Don't play a move more than once
-            if (   bestMove == mp->tableMove
-                || bestMove == mp->killer1
-                || bestMove == mp->killer2
-                || bestMove == mp->counter)
-                return selectNextMove(mp, board, skipQuiets);
-
-            return bestMove;
-        }
-
-        // Out of quiet moves, only bad quiets remain
+        // Out of quiet moves, only bad noisy moves remain
         mp->stage = STAGE_BAD_NOISY;
+        mp->cur = 0;
 
         /* fallthrough */
 
     case STAGE_BAD_NOISY:
 
         // Noisy picker skips all bad noisy moves
-        if (mp->type == NOISY_PICKER) {
-            mp->stage = STAGE_DONE;
-            return NONE_MOVE;
-        }
-
-        // Check to see if there are still more noisy moves
-        if (mp->noisySize != 0){
-
-            // Save the best move before overwriting it
-            bestMove = mp->moves[0];
-
-            // Reduce effective move list size
-            mp->noisySize -= 1;
-            mp->moves[0] = mp->moves[mp->noisySize];
-            mp->values[0] = mp->values[mp->noisySize];
-
-            // Don't play a move more than once
-            if (   bestMove == mp->tableMove
-                || bestMove == mp->killer1
-                || bestMove == mp->killer2
-                || bestMove == mp->counter)
-                return selectNextMove(mp, board, skipQuiets);
-
-            return bestMove;
-        }
+        if (mp->type != NOISY_PICKER && (move = nextListMove(mp, mp->bad)) != NONE_MOVE)
+            return move;
 
         // Out of all captures and quiet moves, move picker complete
         mp->stage = STAGE_DONE;
-
-        /* fallthrough */
+        return NONE_MOVE;
 
     case STAGE_DONE:
         return NONE_MOVE;
@@ -271,44 +241,99 @@ uint16_t selectNextMove(MovePicker* mp, Board* board, int skipQuiets){
     }
 }
 
-int getBestMoveIndex(MovePicker *mp, int start, int end) {
+int partitionEvasions(Board* board, uint16_t* moves, int size){
+
+    int split = 0;
+    uint16_t move;
+
+    // Swap the tactical evasions to the front of the list
+    for (int i = 0; i < size; i++){
+        if (moveIsTactical(board, moves[i])){
+            move = moves[i];
+            moves[i] = moves[split];
+            moves[split++] = move;
+        }
+    }
+
+    return split;
+}
+
+uint16_t nextListMove(MovePicker* mp, int end){
+
+    uint16_t move;
+
+    // Take moves from the list up to end, skipping any already played
+    while (mp->cur < end){
+
+        move = EntryMove(selectBestEntry(mp->entries, mp->cur++, end));
+
+        if (   move != mp->tableMove
+            && move != mp->killer1
+            && move != mp->killer2
+            && move != mp->counter)
+            return move;
+    }
+
+    return NONE_MOVE;
+}
+
+int32_t selectBestEntry(int32_t* entries, int start, int end){
 
     int best = start;
+    int32_t entry;
 
+    // Find the best of the remaining entries, and swap it to the front.
+    // Search usually stops well before the end of the list, so selecting
+    // one entry at a time does less work than sorting the list up front
     for (int i = start + 1; i < end; i++)
-        if (mp->values[i] > mp->values[best])
+        if (entries[i] > entries[best])
             best = i;
 
-    return best;
+    entry = entries[best];
+    entries[best] = entries[start];
+    entries[start] = entry;
+
+    return entry;
 }
 
-void evaluateNoisyMoves(MovePicker* mp){
+void evaluateNoisyMoves(MovePicker* mp, uint16_t* moves, int start, int length){
 
-    int fromType, toType;
+    int fromType, toType, value;
 
     // Use modified MVV-LVA to evaluate moves
-    for (int i = 0; i < mp->noisySize; i++){
+    for (int i = 0; i < length; i++){
 
-        fromType = pieceType(mp->thread->board.squares[MoveFrom(mp->moves[i])]);
-        toType   = pieceType(mp->thread->board.squares[MoveTo(mp->moves[i])]);
+        fromType = pieceType(mp->thread->board.squares[MoveFrom(moves[i])]);
+        toType   = pieceType(mp->thread->board.squares[MoveTo(moves[i])]);
 
         // Use the standard MVV-LVA
-        mp->values[i] = PieceValues[toType][EG] - fromType;
+        value = PieceValues[toType][EG] - fromType;
 
         // A bonus is in order for queen promotions
-        if ((mp->moves[i] & QUEEN_PROMO_MOVE) == QUEEN_PROMO_MOVE)
-            mp->values[i] += PieceValues[QUEEN][EG];
+        if ((moves[i] & QUEEN_PROMO_MOVE) == QUEEN_PROMO_MOVE)
+            value += PieceValues[QUEEN][EG];
 
         // Enpass is a special case of MVV-LVA
-        else if (MoveType(mp->moves[i]) == ENPASS_MOVE)
-            mp->values[i] = PieceValues[PAWN][EG] - PAWN;
+        else if (MoveType(moves[i]) == ENPASS_MOVE)
+            value = PieceValues[PAWN][EG] - PAWN;
 
-        // Later we will flag moves which were passed over in the STAGE_GOOD_NOISY
-        // phase due to failing an SEE(0), by setting the value to -1
-        assert(mp->values[i] >= 0);
+        mp->entries[start + i] = MoveEntry(moves[i], value);
     }
 }
 
+void evaluateQuietMoves(MovePicker* mp, uint16_t* moves, int start, int length){
+
+    int values[MAX_MOVES];
+
+    getHistoryScores(mp->thread, moves, values, 0, length, mp->height);
+
+    // The three histories sum to at most three times 16384 in magnitude.
+    // Sums beyond the packed sixteen bits are rare, and are clamped, so
+    // that every other score keeps its full precision
+    for (int i = 0; i < length; i++)
+        mp->entries[start + i] = MoveEntry(moves[i], MAX(-32768, MIN(32767, values[i])));
+}
+
 int moveIsPsuedoLegal(Board* board, uint16_t move){
 
     int colour = board->turn;
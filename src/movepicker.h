@@ -33,13 +33,18 @@ enum {
 enum {
     NORMAL_PICKER,
     NOISY_PICKER,
+    EVASION_PICKER,
 };
 
+// Each move is packed with its score into a single entry. The score sits
+// in the upper sixteen bits, so that entries compare as their scores do
+#define MoveEntry(move, score) ((int32_t)(score) * 65536 + (int32_t)(move))
+#define EntryMove(entry)       ((uint16_t)(entry))
+
 struct MovePicker {
-    int split, noisySize, quietSize;
+    int cur, bad, split, end;
     int stage, height, type, threshold;
-    int values[MAX_MOVES];
-    uint16_t moves[MAX_MOVES];
+    int32_t entries[MAX_MOVES];
     uint16_t tableMove, killer1, killer2, counter;
     Thread *thread;
 };
@@ -47,8 +52,11 @@ struct MovePicker {
 void initMovePicker(MovePicker* mp, Thread* thread, uint16_t ttMove, int height);
 void initNoisyMovePicker(MovePicker* mp, Thread* thread, int threshold);
 uint16_t selectNextMove(MovePicker* mp, Board* board, int skipQuiets);
-int getBestMoveIndex(MovePicker *mp, int start, int end);
-void evaluateNoisyMoves(MovePicker* mp);
+int partitionEvasions(Board* board, uint16_t* moves, int size);
+uint16_t nextListMove(MovePicker* mp, int end);
+int32_t selectBestEntry(int32_t* entries, int start, int end);
+void evaluateNoisyMoves(MovePicker* mp, uint16_t* moves, int start, int length);
+void evaluateQuietMoves(MovePicker* mp, uint16_t* moves, int start, int length);
 int moveIsPsuedoLegal(Board* board, uint16_t move);
 
 #endif
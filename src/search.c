@@ -49,8 +49,12 @@
 
 int LMRTable[64][64]; // Late Move Reductions, LMRTable[depth][played]
 
+int MultiPV = 1; // Number of principal variations searched and reported
+
 volatile int ABORT_SIGNAL; // Global ABORT flag for threads
 
+extern int ABDADAEnabled; // Defined by Transposition.c
+
 volatile int IS_PONDERING; // Global PONDER flag for threads
 
 
@@ -64,14 +68,13 @@ void initSearch(){
 
 void getBestMove(Thread* threads, Board* board, Limits* limits, uint16_t *best, uint16_t *ponder){
 
-    ABORT_SIGNAL = 0; // Clear the ABORT signal for the new search
-
     updateTT(); // Table is on a new search, thus a new generation
 
     // Before searching, check to see if we are in the Syzygy Tablebases. If so
     // the probe will return 1, will initialize the best move, and will report
     // a depth MAX_PLY - 1 search to the interface. If found, we are done here.
-    if (tablebasesProbeDTZ(board, best)) { *ponder = NONE_MOVE; return; }
+    // The probe knows nothing of searchmoves, so restricted searches skip it
+    if (!limits->searchMovesSize && tablebasesProbeDTZ(board, best)) { *ponder = NONE_MOVE; return; }
 
     // Initialize SearchInfo, used for reporting and time managment logic
     SearchInfo info;
@@ -80,20 +83,36 @@ void getBestMove(Thread* threads, Board* board, Limits* limits, uint16_t *best,
 
     // Setup the thread pool for a new search
     newSearchThreadPool(threads, board, limits, &info);
+    initRootMoves(threads, board, limits);
+    clearSearchingTable();
 
-    // Launch all of the threads
-    pthread_t pthreads[threads[0].nthreads];
-    for (int i = 1; i < threads[0].nthreads; i++)
-        pthread_create(&pthreads[i], NULL, &iterativeDeepening, &threads[i]);
+    // Wake the parked helpers, and search with this thread as the main
+    startSearchTimer(&info, limits);
+    startSearchThreadPool(threads);
     iterativeDeepening((void*) &threads[0]);
 
     // Wait for all (helper) threads to finish
-    for (int i = 1; i < threads[0].nthreads; i++)
-        pthread_join(pthreads[i], NULL);
-
-    // Save the best move and ponder move
-    *best = info.bestMoves[info.depth];
-    *ponder = info.ponderMoves[info.depth];
+    waitSearchThreadPool(threads);
+    stopSearchTimer();
+
+    // Report Transposition Table behaviour for this search
+    #if defined(TTSTATS)
+        TTStats stats = {0};
+        ttstatsThreadPool(threads, &stats);
+        reportTTStats(&stats);
+        reportTableStats(threads);
+    #endif
+
+    // Select the best move and ponder move by a vote of all threads
+    Thread* const bestThread = voteBestMove(threads);
+    *best   = bestThread->bestMove;
+    *ponder = bestThread->ponderMove;
+
+    // The interface last saw the main thread's line. When a helper wins
+    // the vote, report its line, so that the final PV matches the bestmove
+    if (bestThread != &threads[0])
+        uciReport(bestThread, &bestThread->completedPV, bestThread->completedDepth,
+                  0, -MATE, MATE, bestThread->value);
 }
 
 void* iterativeDeepening(void* vthread){
@@ -103,6 +122,8 @@ void* iterativeDeepening(void* vthread){
     Limits* const limits   = thread->limits;
     const int mainThread   = thread->index == 0;
     const int cycle        = thread->index % SMPCycles;
+    const int multiPV      = MAX(1, MIN(MultiPV, thread->rootMovesSize));
+    int value;
 
     // Bind when we expect to deal with Numa
     if (thread->nthreads > 8)
@@ -114,8 +135,36 @@ void* iterativeDeepening(void* vthread){
         // If we abort to here, we stop searching
         if (setjmp(thread->jbuffer)) break;
 
-        // Perform the actual search for the current depth
-        thread->value = aspirationWindow(thread, thread->depth, thread->value);
+        // Windows for each line are centered on the previous iteration
+        for (int i = 0; i < thread->rootMovesSize; i++)
+            thread->rootMoves[i].previousValue = thread->rootMoves[i].value;
+
+        // Perform the actual search for the current depth. Each MultiPV line
+        // searches only the root moves which are not already in an earlier line
+        for (thread->pvIndex = 0; thread->pvIndex < multiPV; thread->pvIndex++){
+
+            RootMove* const rootMoves = thread->rootMoves + thread->pvIndex;
+
+            value = aspirationWindow(thread, thread->depth, thread->pvIndex ? rootMoves->previousValue : thread->value);
+            if (thread->pvIndex == 0) thread->value = value;
+
+            // Order the remaining root moves, placing this line's move first
+            sortRootMoves(rootMoves, thread->rootMovesSize - thread->pvIndex);
+            rootMoves->pv = thread->pv;
+        }
+
+        // Order the lines, and adopt the best one as this iteration's result
+        if (thread->rootMovesSize){
+            sortRootMoves(thread->rootMoves, multiPV);
+            thread->value = thread->rootMoves[0].value;
+            thread->pv    = thread->rootMoves[0].pv;
+        }
+
+        // Save the results of this completed iteration for voting
+        thread->completedDepth = thread->depth;
+        thread->completedPV    = thread->pv;
+        thread->bestMove       = thread->pv.line[0];
+        thread->ponderMove     = thread->pv.length >= 2 ? thread->pv.line[1] : NONE_MOVE;
 
         // Occasionally skip depths using Laser's method
         if (!mainThread && (thread->depth + cycle) % SkipDepths[cycle] == 0)
@@ -131,7 +180,10 @@ void* iterativeDeepening(void* vthread){
         info->ponderMoves[thread->depth] = thread->pv.length >= 2 ? thread->pv.line[1] : NONE_MOVE;
 
         // Send information about this search to the interface
-        uciReport(thread->threads, -MATE, MATE, thread->value);
+        if (thread->rootMovesSize == 0)
+            uciReport(thread, &thread->pv, thread->depth, 0, -MATE, MATE, thread->value);
+        for (int i = 0; i < thread->rootMovesSize && i < multiPV; i++)
+            uciReport(thread, &thread->rootMoves[i].pv, thread->depth, i, -MATE, MATE, thread->rootMoves[i].value);
 
         // Update time allocation based on score and pv changes
         updateTimeManagment(info, limits, thread->depth, thread->value);
@@ -143,7 +195,8 @@ void* iterativeDeepening(void* vthread){
         if (   (limits->limitedBySelf  && terminateTimeManagment(info))
             || (limits->limitedBySelf  && elapsedTime(info) > info->maxUsage)
             || (limits->limitedByTime  && elapsedTime(info) > limits->timeLimit)
-            || (limits->limitedByDepth && thread->depth >= limits->depthLimit))
+            || (limits->limitedByDepth && thread->depth >= limits->depthLimit)
+            || (limits->limitedByNodes && nodesSearchedThreadPool(thread->threads) >= limits->nodeLimit))
             break;
     }
 
@@ -153,6 +206,126 @@ void* iterativeDeepening(void* vthread){
     return NULL;
 }
 
+void initRootMoves(Thread* threads, Board* board, Limits* limits){
+
+    int size = 0;
+    uint16_t moves[MAX_MOVES];
+    Thread* const thread = &threads[0];
+
+    genAllLegalMoves(board, moves, &size);
+
+    // Restrict the root to the searchmoves, unless none of them are legal
+    thread->rootMovesSize = 0;
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < limits->searchMovesSize; j++)
+            if (moves[i] == limits->searchMoves[j])
+                thread->rootMoves[thread->rootMovesSize++].move = moves[i];
+
+    if (thread->rootMovesSize == 0)
+        for (int i = 0; i < size; i++)
+            thread->rootMoves[thread->rootMovesSize++].move = moves[i];
+
+    for (int i = 0; i < thread->rootMovesSize; i++){
+        thread->rootMoves[i].value = -MATE;
+        thread->rootMoves[i].nodes = 0ull;
+    }
+
+    // Each helper orders its own copy of the list as it searches
+    for (int i = 1; i < thread->nthreads; i++){
+        threads[i].rootMovesSize = thread->rootMovesSize;
+        memcpy(threads[i].rootMoves, thread->rootMoves, sizeof(RootMove) * thread->rootMovesSize);
+    }
+}
+
+void prepareRootMoves(Thread* thread, uint16_t ttMove){
+
+    RootMove tableMove;
+    RootMove* const rootMoves = thread->rootMoves + thread->pvIndex;
+    const int size = thread->rootMovesSize - thread->pvIndex;
+
+    // Move the table move to the front, so that after an aspiration
+    // window fails high, the move which did so is searched first
+    for (int i = 0; i < size; i++){
+        if (rootMoves[i].move == ttMove){
+            tableMove = rootMoves[i];
+            memmove(rootMoves + 1, rootMoves, sizeof(RootMove) * i);
+            rootMoves[0] = tableMove;
+            break;
+        }
+    }
+
+    // Values and node counts are collected anew by each root search,
+    // leaving alone those of the MultiPV lines which were already found
+    for (int i = 0; i < size; i++){
+        rootMoves[i].value = -MATE;
+        rootMoves[i].nodes = 0ull;
+    }
+}
+
+void sortRootMoves(RootMove* rootMoves, int size){
+
+    RootMove temp;
+
+    // Stable insertion sort by value, and then by subtree size. Moves which
+    // failed low share a value of -MATE, and so are ordered by their nodes
+    for (int i = 1; i < size; i++){
+
+        int j = i;
+        temp = rootMoves[i];
+
+        while (   j > 0
+               && (   rootMoves[j-1].value < temp.value
+                   || (rootMoves[j-1].value == temp.value && rootMoves[j-1].nodes < temp.nodes))){
+            rootMoves[j] = rootMoves[j-1];
+            j--;
+        }
+
+        rootMoves[j] = temp;
+    }
+}
+
+Thread* voteBestMove(Thread* threads){
+
+    const int nthreads = threads[0].nthreads;
+
+    int64_t votes[nthreads];
+    int minValue = threads[0].value;
+    Thread* bestThread = &threads[0];
+
+    // Scores are weighted relative to the worst completed result
+    for (int i = 1; i < nthreads; i++)
+        if (threads[i].completedDepth > 0)
+            minValue = MIN(minValue, threads[i].value);
+
+    // Each thread votes for its best move, weighted by its score and depth
+    for (int i = 0; i < nthreads; i++) {
+        votes[i] = 0;
+        for (int j = 0; j < nthreads; j++)
+            if (threads[j].completedDepth > 0 && threads[j].bestMove == threads[i].bestMove)
+                votes[i] += (int64_t)(threads[j].value - minValue + 14) * threads[j].completedDepth;
+    }
+
+    for (int i = 1; i < nthreads; i++) {
+
+        Thread* const thread = &threads[i];
+
+        if (thread->completedDepth == 0)
+            continue;
+
+        // Always prefer the shortest proven mate, otherwise take the most votes
+        if (bestThread->value >= MATE_IN_MAX) {
+            if (thread->value > bestThread->value)
+                bestThread = thread;
+        }
+
+        else if (   thread->value >= MATE_IN_MAX
+                 || votes[i] > votes[bestThread->index])
+            bestThread = thread;
+    }
+
+    return bestThread;
+}
+
 int aspirationWindow(Thread* thread, int depth, int lastValue){
 
     const int mainThread = thread->index == 0;
@@ -172,7 +345,7 @@ int aspirationWindow(Thread* thread, int depth, int lastValue){
 
         // Report lower and upper bounds after at a certain time
         if (mainThread && elapsedTime(thread->info) >= WindowTimerMS)
-            uciReport(thread->threads, alpha, beta, value);
+            uciReport(thread, &thread->pv, depth, thread->pvIndex, alpha, beta, value);
 
         // Search failed low
         if (value <= alpha) {
@@ -199,10 +372,14 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     int quiets = 0, played = 0, hist = 0, cmhist = 0, fmhist = 0;
     int ttHit, ttValue = 0, ttEval = 0, ttDepth = 0, ttBound = 0;
     int R, newDepth, rAlpha, rBeta, oldAlpha = alpha;
-    int inCheck, isQuiet, improving, extension, singular, skipQuiets = 0;
+    int inCheck, isQuiet, givesCheck, improving, extension, singular, skipQuiets = 0;
+    int abdada, isDeferred, deferred = 0, ndeferred = 0, rootIndex = thread->pvIndex;
     int eval, value = -MATE, best = -MATE, futilityMargin, seeMargin[2];
     uint16_t move, ttMove = NONE_MOVE, bestMove = NONE_MOVE, quietsTried[MAX_MOVES];
+    uint16_t deferredMoves[MAX_MOVES];
+    uint64_t rootNodes = 0;
     MovePicker movePicker;
+    CheckInfo checkInfo;
 
     PVariation lpv;
     lpv.length = 0;
@@ -217,8 +394,8 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     depth = MAX(0, depth);
 
     // Updates for UCI reporting
-    thread->seldepth = RootNode ? 0 : MAX(thread->seldepth, height);
-    thread->nodes++;
+    relaxedStore(thread->seldepth, RootNode ? 0 : MAX(relaxedLoad(thread->seldepth), height));
+    relaxedIncrement(thread->nodes);
 
     // Step 2. Abort Check. Exit the search if signaled by main thread or the
     // UCI thread, or if the search time has expired outside pondering mode
@@ -236,7 +413,7 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
 
         // Check to see if we have exceeded the maxiumum search draft
         if (height >= MAX_PLY)
-            return evaluateBoard(board, &thread->pktable);
+            return evaluateThread(thread, board);
 
         // Mate Distance Pruning. Check to see if this line is so
         // good, or so bad, that being mated in the ply, or  mating in
@@ -247,9 +424,11 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     }
 
     // Step 4. Probe the Transposition Table, adjust the value, and consider cutoffs
+    TTStat(&thread->ttstats, probes);
     if ((ttHit = getTTEntry(board->hash, &ttMove, &ttValue, &ttEval, &ttDepth, &ttBound))){
 
         ttValue = valueFromTT(ttValue, height); // Adjust any MATE scores
+        TTStat(&thread->ttstats, hits);
 
         // Only cut with a greater depth search, and do not return
         // when in a PvNode, unless we would otherwise hit a qsearch
@@ -258,8 +437,10 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
             // Table is exact or produces a cutoff
             if (    ttBound == BOUND_EXACT
                 || (ttBound == BOUND_LOWER && ttValue >= beta)
-                || (ttBound == BOUND_UPPER && ttValue <= alpha))
+                || (ttBound == BOUND_UPPER && ttValue <= alpha)) {
+                TTStat(&thread->ttstats, cutoffs);
                 return ttValue;
+            }
         }
     }
 
@@ -268,7 +449,7 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     // as well as to not probe at the Root. The return is defined by the Fathom API
     if ((tbresult = tablebasesProbeWDL(board, depth, height)) != TB_RESULT_FAILED){
 
-        thread->tbhits++; // Increment tbhits counter for this thread
+        relaxedIncrement(thread->tbhits); // Increment tbhits counter for this thread
 
         // Convert the WDL value to a score. We consider blessed losses
         // and cursed wins to be a draw, and thus set value to zero.
@@ -286,7 +467,7 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
             || (ttBound == BOUND_LOWER && value >= beta)
             || (ttBound == BOUND_UPPER && value <= alpha)){
 
-            storeTTEntry(board->hash, NONE_MOVE, value, VALUE_NONE, MAX_PLY-1, ttBound);
+            recordTTStore(&thread->ttstats, storeTTEntry(board->hash, NONE_MOVE, value, VALUE_NONE, MAX_PLY-1, ttBound));
             return value;
         }
     }
@@ -298,7 +479,7 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
 
     // Save off static evaluation history. Reuse TT entry eval if possible
     eval = thread->evalStack[height] = ttHit && ttEval != VALUE_NONE ? ttEval
-                                     : evaluateBoard(board, &thread->pktable);
+                                     : evaluateThread(thread, board);
 
     // Futility Pruning Margin
     futilityMargin = eval + FutilityMargin * depth;
@@ -368,9 +549,8 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
 
         while ((move = selectNextMove(&movePicker, board, 1)) != NONE_MOVE){
 
-            // Apply move, skip if move is illegal
-            if (!apply(thread, board, move, height))
-                continue;
+            // Apply move, which the Move Picker has verified is legal
+            apply(thread, board, move, height);
 
             // Perform a reduced depth verification search
             value = -search(thread, &lpv, -rBeta, -rBeta+1, depth-4, height+1);
@@ -384,20 +564,48 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     }
 
     // Step 11. Initialize the Move Picker and being searching through each
-    // move one at a time, until we run out or a move generates a cutoff
+    // move one at a time, until we run out or a move generates a cutoff.
+    // Moves deferred by ABDADA are searched once the Move Picker is empty.
+    // The RootNode instead walks the list of root moves built for this search
+    abdada = ABDADAEnabled && thread->nthreads > 1 && !RootNode && depth >= ABDADADepth;
     initMovePicker(&movePicker, thread, ttMove, height);
-    while ((move = selectNextMove(&movePicker, board, skipQuiets)) != NONE_MOVE){
+    initCheckInfo(board, &checkInfo);
+    if (RootNode) prepareRootMoves(thread, ttMove);
+    while (1){
+
+        isDeferred = 0;
+
+        // Select the next root move, skipping quiets once they are pruned
+        if (RootNode){
+            if (rootIndex == thread->rootMovesSize) break;
+            move = thread->rootMoves[rootIndex++].move;
+            if (skipQuiets && !moveIsTactical(board, move)) continue;
+        }
+
+        // Select the next move, falling back to any deferred moves
+        else if ((move = selectNextMove(&movePicker, board, skipQuiets)) == NONE_MOVE){
+            if (deferred == ndeferred) break;
+            move = deferredMoves[deferred++];
+            isDeferred = 1;
+        }
 
         // If this move is quiet we will save it to a list of attemped quiets.
         // Also lookup the history score, as we will in most cases need it.
+        // A deferred quiet is already in the list, but is moved to the end,
+        // as the history update treats the final entry as the best move
         if ((isQuiet = !moveIsTactical(board, move))){
-            quietsTried[quiets++] = move;
+            if (!isDeferred) quietsTried[quiets++] = move;
+            else moveQuietToEnd(quietsTried, quiets, move);
             getHistory(thread, move, height, &hist, &cmhist, &fmhist);
         }
 
+        // Identify checking moves before making them, to exempt them from pruning
+        givesCheck = moveGivesCheck(board, move, &checkInfo);
+
         // Step 12. Quiet Move Pruning. Prune any quiet move that meets one
-        // of the criteria below, only after proving a non mated line exists
-        if (isQuiet && best > MATED_IN_MAX) {
+        // of the criteria below, only after proving a non mated line exists.
+        // Deferred moves have already survived the pruning steps once
+        if (isQuiet && best > MATED_IN_MAX && !isDeferred) {
 
             // Step 12A. Futility Pruning. If our score is far below alpha, and we
             // don't expect anything from this move, we can skip all other quiets
@@ -415,33 +623,51 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
 
             // Step 12C. Counter Move Pruning. Moves with poor counter
             // move history are pruned at near leaf nodes of the search.
-            if (   depth <= CounterMovePruningDepth[improving]
+            if (  !givesCheck
+                && depth <= CounterMovePruningDepth[improving]
                 && cmhist < CounterMoveHistoryLimit[improving])
                 continue;
 
             // Step 12D. Follow Up Move Pruning. Moves with poor follow up
             // move history are pruned at near leaf nodes of the search.
-            if (   depth <= FollowUpMovePruningDepth[improving]
+            if (  !givesCheck
+                && depth <= FollowUpMovePruningDepth[improving]
                 && fmhist < FollowUpMoveHistoryLimit[improving])
                 continue;
         }
 
         // Step 13. Static Exchange Evaluation Pruning. Prune moves which fail
         // to beat a depth dependent SEE threshold. The use of movePicker.stage
-        // is a speedup, which assumes that good noisy moves have a positive SEE
-        if (    best > MATED_IN_MAX
+        // is a speedup, which assumes that good noisy moves have a positive SEE.
+        // Moves which give check are not pruned, as they may force a response
+        if (   !isDeferred
+            && !givesCheck
+            &&  best > MATED_IN_MAX
             &&  depth <= SEEPruningDepth
             &&  movePicker.stage > STAGE_GOOD_NOISY
             && !staticExchangeEvaluation(board, move, seeMargin[isQuiet]))
             continue;
 
-        // Apply move, skip if move is illegal
-        if (!apply(thread, board, move, height))
+        // Apply move, which the Move Picker has verified is legal
+        apply(thread, board, move, height);
+
+        // Step 13B. ABDADA. Once the eldest brother has been searched, defer
+        // any move whose position another thread is searching at this depth
+        if (abdada && !isDeferred && played && isSearchingTable(board->hash, depth)){
+            revert(thread, board, move, height);
+            deferredMoves[ndeferred++] = move;
             continue;
+        }
+
+        // Let other threads know we are searching this position
+        if (abdada) markSearchingTable(board->hash, depth);
 
         // Update counter of moves actually played
         played += 1;
 
+        // Measure the size of each root move's subtree
+        if (RootNode) rootNodes = relaxedLoad(thread->nodes);
+
         // Step 14. Late Move Reductions. Compute the reduction,
         // allow the later steps to perform the reduced searches
         if (isQuiet && depth > 2 && played > 1){
@@ -505,8 +731,15 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
             value = -search(thread, &lpv, -beta, -alpha, newDepth-1, height+1);
 
         // Revert the board state
+        if (abdada) unmarkSearchingTable(board->hash, depth);
         revert(thread, board, move, height);
 
+        // Save the root move's value, unless it failed low, and its subtree size
+        if (RootNode){
+            thread->rootMoves[rootIndex-1].value = played == 1 || value > alpha ? value : -MATE;
+            thread->rootMoves[rootIndex-1].nodes = relaxedLoad(thread->nodes) - rootNodes;
+        }
+
         // Step 17. Update search stats for the best move and its value. Update
         // our lower bound (alpha) if exceeded, and also update the PV in that case
         if (value > best){
@@ -536,13 +769,18 @@ int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int h
     if (played == 0) return inCheck ? -MATE + height : 0;
 
     // Step 19. Update History counters on a fail high for a quiet move
-    if (best >= beta && !moveIsTactical(board, bestMove))
+    if (best >= beta && !moveIsTactical(board, bestMove)){
+        assert(quiets > 0 && quietsTried[quiets-1] == bestMove);
         updateHistoryHeuristics(thread, quietsTried, quiets, height, depth*depth);
+    }
 
-    // Step 20. Store results of search into the table
-    ttBound = best >= beta    ? BOUND_LOWER
-            : best > oldAlpha ? BOUND_EXACT : BOUND_UPPER;
-    storeTTEntry(board->hash, bestMove, valueToTT(best, height), eval, depth, ttBound);
+    // Step 20. Store results of search into the table. Later MultiPV lines
+    // exclude the best moves, so their root results would mislead the table
+    if (!RootNode || !thread->pvIndex){
+        ttBound = best >= beta    ? BOUND_LOWER
+                : best > oldAlpha ? BOUND_EXACT : BOUND_UPPER;
+        recordTTStore(&thread->ttstats, storeTTEntry(board->hash, bestMove, valueToTT(best, height), eval, depth, ttBound));
+    }
 
     return best;
 }
@@ -562,8 +800,8 @@ int qsearch(Thread* thread, PVariation* pv, int alpha, int beta, int height){
     pv->length = 0;
 
     // Updates for UCI reporting
-    thread->seldepth = MAX(thread->seldepth, height);
-    thread->nodes++;
+    relaxedStore(thread->seldepth, MAX(relaxedLoad(thread->seldepth), height));
+    relaxedIncrement(thread->nodes);
 
     // Step 1. Abort Check. Exit the search if signaled by main thread or the
     // UCI thread, or if the search time has expired outside pondering mode
@@ -578,25 +816,29 @@ int qsearch(Thread* thread, PVariation* pv, int alpha, int beta, int height){
     // Step 3. Max Draft Cutoff. If we are at the maximum search draft,
     // then end the search here with a static eval of the current board
     if (height >= MAX_PLY)
-        return evaluateBoard(board, &thread->pktable);
+        return evaluateThread(thread, board);
 
     // Step 4. Probe the Transposition Table, adjust the value, and consider cutoffs
+    TTStat(&thread->ttstats, probes);
     if ((ttHit = getTTEntry(board->hash, &ttMove, &ttValue, &ttEval, &ttDepth, &ttBound))){
 
         ttValue = valueFromTT(ttValue, height); // Adjust any MATE scores
+        TTStat(&thread->ttstats, hits);
 
         // Table is exact or produces a cutoff
         if (    ttBound == BOUND_EXACT
             || (ttBound == BOUND_LOWER && ttValue >= beta)
-            || (ttBound == BOUND_UPPER && ttValue <= alpha))
+            || (ttBound == BOUND_UPPER && ttValue <= alpha)) {
+            TTStat(&thread->ttstats, cutoffs);
             return ttValue;
+        }
     }
 
     // Step 5. Eval Pruning. If a static evaluation of the board will
     // exceed beta, then we can stop the search here. Also, if the static
     // eval exceeds alpha, we can call our static eval the new alpha
     best = eval = ttHit && ttEval != VALUE_NONE ? ttEval
-                : evaluateBoard(board, &thread->pktable);
+                : evaluateThread(thread, board);
     alpha = MAX(alpha, eval);
     if (alpha >= beta) return eval;
 
@@ -612,9 +854,8 @@ int qsearch(Thread* thread, PVariation* pv, int alpha, int beta, int height){
     initNoisyMovePicker(&movePicker, thread, MAX(QSEEMargin, margin));
     while ((move = selectNextMove(&movePicker, board, 1)) != NONE_MOVE) {
 
-        // Apply move, skip if move is illegal
-        if (!apply(thread, board, move, height))
-            continue;
+        // Apply move, which the Move Picker has verified is legal
+        apply(thread, board, move, height);
 
         // Search next depth
         value = -qsearch(thread, &lpv, -beta, -alpha, height+1);
@@ -738,12 +979,39 @@ int staticExchangeEvaluation(Board* board, uint16_t move, int threshold){
     return board->turn != colour;
 }
 
+int evaluateThread(Thread* thread, Board* board){
+
+    int eval;
+
+    // Reuse a cached static eval for this position if we have one
+    if (getEvalCacheEntry(&thread->evcache, board->hash, &eval))
+        return eval;
+
+    eval = evaluateBoard(board, &thread->pktable, &thread->mtable);
+    storeEvalCacheEntry(&thread->evcache, board->hash, eval);
+    return eval;
+}
+
 int moveIsTactical(Board* board, uint16_t move){
     return board->squares[MoveTo(move)] != EMPTY
         || MoveType(move) == PROMOTION_MOVE
         || MoveType(move) == ENPASS_MOVE;
 }
 
+void moveQuietToEnd(uint16_t* quiets, int length, uint16_t move){
+
+    int i = 0;
+
+    // Find the move, and shift the later quiets down to fill its place
+    while (i < length && quiets[i] != move) i++;
+    assert(i < length);
+
+    for (; i < length - 1; i++)
+        quiets[i] = quiets[i+1];
+
+    quiets[length-1] = move;
+}
+
 int hasNonPawnMaterial(Board* board, int turn){
     uint64_t friendly = board->colours[turn];
     uint64_t kings = board->pieces[KING];
@@ -822,9 +1090,8 @@ int moveIsSingular(Thread* thread, uint16_t ttMove, int ttValue, int depth, int
         // Skip the table move
         if (move == ttMove) continue;
 
-        // Apply move, skip if move is illegal
-        if (!apply(thread, board, move, height))
-            continue;
+        // Apply move, which the Move Picker has verified is legal
+        apply(thread, board, move, height);
 
         // Perform a reduced depth search on a null rbeta window
         value = -search(thread, &lpv, -rBeta-1, -rBeta, depth / 2 - 1, height+1);
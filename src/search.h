@@ -40,6 +40,13 @@ struct PVariation {
     int length;
 };
 
+struct RootMove {
+    uint16_t move;
+    int value, previousValue;
+    uint64_t nodes;
+    PVariation pv;
+};
+
 
 void initSearch();
 
@@ -47,6 +54,14 @@ void getBestMove(Thread* threads, Board* board, Limits* limits, uint16_t *best,
 
 void* iterativeDeepening(void* vthread);
 
+void initRootMoves(Thread* threads, Board* board, Limits* limits);
+
+void prepareRootMoves(Thread* thread, uint16_t ttMove);
+
+void sortRootMoves(RootMove* rootMoves, int size);
+
+Thread* voteBestMove(Thread* threads);
+
 int aspirationWindow(Thread* thread, int depth, int lastValue);
 
 int search(Thread* thread, PVariation* pv, int alpha, int beta, int depth, int height);
@@ -55,8 +70,12 @@ int qsearch(Thread* thread, PVariation* pv, int alpha, int beta, int height);
 
 int staticExchangeEvaluation(Board* board, uint16_t move, int threshold);
 
+int evaluateThread(Thread* thread, Board* board);
+
 int moveIsTactical(Board* board, uint16_t move);
 
+void moveQuietToEnd(uint16_t* quiets, int length, uint16_t move);
+
 int hasNonPawnMaterial(Board* board, int turn);
 
 int valueFromTT(int value, int height);
@@ -85,6 +104,8 @@ static const int BetaMargin = 85;
 
 static const int NullMovePruningDepth = 2;
 
+static const int ABDADADepth = 6;
+
 static const int ProbCutDepth = 5;
 static const int ProbCutMargin = 100;
 
@@ -101,7 +101,7 @@ void runTexelTuning(Thread *thread) {
     printf("\nTuner Will Be Tuning %d Terms...", NTERMS);
 
     printf("\n\nSetting Table size to 1MB for speed...");
-    initTT(1);
+    initTT(1, thread);
 
     printf("\n\nAllocating Memory for Texel Entries [%dKB]...",
            (int)(NPOSITIONS * sizeof(TexelEntry) / 1024));
@@ -204,7 +204,7 @@ void initTexelEntries(TexelEntry *tes, Thread *thread) {
         // Vectorize the evaluation coefficients and save the eval
         // relative to WHITE. We must first clear the coeff vector.
         T = EmptyTrace;
-        tes[i].eval = evaluateBoard(&thread->board, NULL);
+        tes[i].eval = evaluateBoard(&thread->board, NULL, NULL);
         if (thread->board.turn == BLACK) tes[i].eval *= -1;
         initCoefficients(coeffs);
 
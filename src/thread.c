@@ -16,7 +16,9 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <assert.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -28,46 +30,182 @@
 #include "types.h"
 #include "windows.h"
 
+extern int PawnHashShared; // Defined by Transposition.c
+
+static Thread* allocThreadPool(int nthreads){
+
+    void* memory = NULL;
+
+    // Page alignment of the Thread pads it to whole pages
+    assert(sizeof(Thread) % THREAD_ALIGNMENT == 0);
+
+    // Each Thread starts on its own page and spans whole pages, so that its
+    // pages may be first-touched, and thus placed, by the OS thread which
+    // owns it. The allocation itself does not touch the memory
+#if defined(_WIN32) || defined(_WIN64)
+    memory = _aligned_malloc(sizeof(Thread) * nthreads, THREAD_ALIGNMENT);
+#else
+    if (posix_memalign(&memory, THREAD_ALIGNMENT, sizeof(Thread) * nthreads))
+        memory = NULL;
+#endif
+
+    return memory;
+}
+
+static void freeThreadPool(Thread* threads){
+#if defined(_WIN32) || defined(_WIN64)
+    _aligned_free(threads);
+#else
+    free(threads);
+#endif
+}
+
+static void initThread(Thread* thread){
+
+    Thread* const threads = thread->threads;
+
+    // Zero the Thread, touching each of its pages from this OS thread
+    memset((char*)thread + offsetof(Thread, limits), 0,
+           sizeof(Thread) - offsetof(Thread, limits));
+
+    relaxedStore(thread->nodes, 0ull);
+    relaxedStore(thread->tbhits, 0ull);
+    relaxedStore(thread->seldepth, 0);
+
+    // Offset stacks so root position can look backwards
+    thread->evalStack = &(thread->_evalStack[4]);
+    thread->moveStack = &(thread->_moveStack[4]);
+    thread->pieceStack = &(thread->_pieceStack[4]);
+
+    // Each thread owns a Pawn King Table, unless they are shared
+    initPawnKingTable(&thread->pktable,
+        thread->index > 0 && PawnHashShared ? &threads[0].pktable : NULL);
+
+    // Each thread owns a cache of static evaluations
+    initEvalCache(&thread->evcache);
+}
+
+static void resetThread(Thread* thread){
+    clearPawnKingTable(&thread->pktable);
+    clearEvalCache(&thread->evcache);
+    memset(&thread->mtable, 0, sizeof(MaterialTable));
+    memset(&thread->killers, 0, sizeof(KillerTable));
+    memset(&thread->cmtable, 0, sizeof(CounterMoveTable));
+    memset(&thread->history, 0, sizeof(HistoryTable));
+    memset(&thread->continuation, 0, sizeof(ContinuationTable));
+}
+
+static void searchTask(Thread* thread){
+    iterativeDeepening(thread);
+}
+
+static void wakeThreadPool(Thread* threads, void (*task)(Thread*)){
+
+    for (int i = 1; i < threads[0].nthreads; i++){
+        pthread_mutex_lock(&threads[i].lock);
+        threads[i].task = task;
+        threads[i].searching = 1;
+        pthread_cond_signal(&threads[i].wakeup);
+        pthread_mutex_unlock(&threads[i].lock);
+    }
+}
+
+static void* parkedThreadLoop(void* vthread){
+
+    Thread* const thread = (Thread*) vthread;
+
+    // Bind before initializing, so our memory is placed on our node
+    if (thread->nthreads > 8)
+        bindThisThread(thread->index);
+
+    initThread(thread);
+
+    pthread_mutex_lock(&thread->lock);
+
+    // Let the pool know that this helper is initialized
+    thread->searching = 0;
+    pthread_cond_signal(&thread->wakeup);
+
+    while (1) {
+
+        // Sleep until there is a new task, or the pool is deleted
+        while (!thread->searching && !thread->exiting)
+            pthread_cond_wait(&thread->wakeup, &thread->lock);
+
+        if (thread->exiting) break;
+
+        pthread_mutex_unlock(&thread->lock);
+        thread->task(thread);
+        pthread_mutex_lock(&thread->lock);
+
+        // Let the main thread know this helper is finished
+        thread->searching = 0;
+        pthread_cond_signal(&thread->wakeup);
+    }
+
+    pthread_mutex_unlock(&thread->lock);
+
+    return NULL;
+}
+
 Thread* createThreadPool(int nthreads){
 
-    Thread* threads = malloc(sizeof(Thread) * nthreads);
+    Thread* threads = allocThreadPool(nthreads);
 
+    // Threads will know of each other
     for (int i = 0; i < nthreads; i++){
-
-        // Threads will know of each other
         threads[i].index = i;
         threads[i].threads = threads;
         threads[i].nthreads = nthreads;
+    }
 
-        // Offset stacks so root position can look backwards
-        threads[i].evalStack = &(threads[i]._evalStack[4]);
-        threads[i].moveStack = &(threads[i]._moveStack[4]);
-        threads[i].pieceStack = &(threads[i]._pieceStack[4]);
+    // The main thread is initialized by the caller's OS thread
+    initThread(&threads[0]);
 
-        // Zero out the stack, most importantly the first four slots
-        memset(&threads[i]._evalStack, 0, sizeof(int) * (MAX_PLY + 4));
-        memset(&threads[i]._moveStack, 0, sizeof(uint16_t) * (MAX_PLY + 4));
-        memset(&threads[i]._pieceStack, 0, sizeof(int) * (MAX_PLY + 4));
+    // Helper threads are started once and parked between searches. Each
+    // one initializes its own Thread, and we wait for that to finish
+    for (int i = 1; i < nthreads; i++){
+        threads[i].searching = 1;
+        threads[i].exiting = 0;
+        pthread_mutex_init(&threads[i].lock, NULL);
+        pthread_cond_init(&threads[i].wakeup, NULL);
+        pthread_create(&threads[i].pthread, NULL, &parkedThreadLoop, &threads[i]);
     }
 
-    resetThreadPool(threads);
+    waitSearchThreadPool(threads);
 
     return threads;
 }
 
+void deleteThreadPool(Thread* threads){
+
+    // Wake each helper so that it may exit, and then wait for it
+    for (int i = 1; i < threads[0].nthreads; i++){
+        pthread_mutex_lock(&threads[i].lock);
+        threads[i].exiting = 1;
+        pthread_cond_signal(&threads[i].wakeup);
+        pthread_mutex_unlock(&threads[i].lock);
+        pthread_join(threads[i].pthread, NULL);
+        pthread_mutex_destroy(&threads[i].lock);
+        pthread_cond_destroy(&threads[i].wakeup);
+    }
+
+    for (int i = 0; i < threads[0].nthreads; i++) {
+        freePawnKingTable(&threads[i].pktable);
+        freeEvalCache(&threads[i].evcache);
+    }
+
+    freeThreadPool(threads);
+}
+
 void resetThreadPool(Thread* threads){
 
     // Reset the per-thread tables, used for move ordering,
     // and evaluation caching. This is needed for ucinewgame
     // calls in order to ensure deterministic behaviour
 
-    for (int i = 0; i < threads[0].nthreads; i++){
-        memset(&threads[i].pktable, 0, sizeof(PawnKingTable));
-        memset(&threads[i].killers, 0, sizeof(KillerTable));
-        memset(&threads[i].cmtable, 0, sizeof(CounterMoveTable));
-        memset(&threads[i].history, 0, sizeof(HistoryTable));
-        memset(&threads[i].continuation, 0, sizeof(ContinuationTable));
-    }
+    for (int i = 0; i < threads[0].nthreads; i++)
+        resetThread(&threads[i]);
 }
 
 void newSearchThreadPool(Thread* threads, Board* board, Limits* limits, SearchInfo* info){
@@ -86,17 +224,44 @@ void newSearchThreadPool(Thread* threads, Board* board, Limits* limits, SearchIn
 
         // Zero out our depth and stat tracking
         threads[i].depth  = 0;
-        threads[i].nodes  = 0ull;
-        threads[i].tbhits = 0ull;
+        threads[i].completedDepth = 0;
+        relaxedStore(threads[i].nodes, 0ull);
+        relaxedStore(threads[i].tbhits, 0ull);
+        memset(&threads[i].ttstats, 0, sizeof(TTStats));
+        threads[i].pktable.probes = threads[i].pktable.hits = 0ull;
+        threads[i].evcache.probes = threads[i].evcache.hits = 0ull;
+    }
+}
+
+void startSearchThreadPool(Thread* threads){
+    wakeThreadPool(threads, &searchTask);
+}
+
+void waitSearchThreadPool(Thread* threads){
+
+    for (int i = 1; i < threads[0].nthreads; i++){
+        pthread_mutex_lock(&threads[i].lock);
+        while (threads[i].searching)
+            pthread_cond_wait(&threads[i].wakeup, &threads[i].lock);
+        pthread_mutex_unlock(&threads[i].lock);
     }
 }
 
+void runThreadPool(Thread* threads, void (*task)(Thread*)){
+
+    // Run a task on every Thread in the pool, with the calling OS
+    // thread acting as the main thread, and wait for all to finish
+    wakeThreadPool(threads, task);
+    task(&threads[0]);
+    waitSearchThreadPool(threads);
+}
+
 uint64_t nodesSearchedThreadPool(Thread* threads){
 
     uint64_t nodes = 0ull;
 
     for (int i = 0; i < threads[0].nthreads; i++)
-        nodes += threads[i].nodes;
+        nodes += relaxedLoad(threads[i].nodes);
 
     return nodes;
 }
@@ -106,7 +271,13 @@ uint64_t tbhitsSearchedThreadPool(Thread* threads){
     uint64_t tbhits = 0ull;
 
     for (int i = 0; i < threads[0].nthreads; i++)
-        tbhits += threads[i].tbhits;
+        tbhits += relaxedLoad(threads[i].tbhits);
 
     return tbhits;
 }
+
+void ttstatsThreadPool(Thread* threads, TTStats* stats){
+
+    for (int i = 0; i < threads[0].nthreads; i++)
+        mergeTTStats(stats, &threads[i].ttstats);
+}
@@ -19,26 +19,62 @@
 #ifndef _THREAD_H
 #define _THREAD_H
 
+#include <pthread.h>
 #include <setjmp.h>
+#include <stdatomic.h>
 
 #include "board.h"
 #include "search.h"
 #include "transposition.h"
 #include "types.h"
 
+// Hot counters are written only by their owner, but are read by the main
+// thread while searching. Relaxed loads and stores keep those reads defined,
+// without paying for a locked read-modify-write on every node
+#define relaxedLoad(x)      atomic_load_explicit(&(x), memory_order_relaxed)
+#define relaxedStore(x, v)  atomic_store_explicit(&(x), (v), memory_order_relaxed)
+#define relaxedIncrement(x) relaxedStore((x), relaxedLoad(x) + 1)
+
+enum { CACHE_LINE_SIZE = 64, THREAD_ALIGNMENT = 4096 };
+
 struct Thread {
 
-    Limits* limits;
+    // Hot counters are kept together on a cache line of their own. Aligning
+    // the Thread to a page also pads its size to whole pages, so that no two
+    // Threads in the pool ever share a page
+    _Alignas(THREAD_ALIGNMENT) _Atomic uint64_t nodes;
+    _Atomic uint64_t tbhits;
+    _Atomic int seldepth;
+
+    // Set by the creator of the pool, before the owner initializes the rest
+    _Alignas(CACHE_LINE_SIZE) int index;
+    int nthreads;
+    Thread* threads;
+
+    pthread_t pthread;
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+    void (*task)(Thread*);
+    int searching;
+    int exiting;
+
+    _Alignas(CACHE_LINE_SIZE) Limits* limits;
     SearchInfo* info;
 
     Board board;
     PVariation pv;
 
+    int pvIndex;
+    int rootMovesSize;
+    RootMove rootMoves[MAX_MOVES];
+
     int value;
     int depth;
-    int seldepth;
-    uint64_t nodes;
-    uint64_t tbhits;
+    int completedDepth;
+    PVariation completedPV;
+    uint16_t bestMove;
+    uint16_t ponderMove;
+    TTStats ttstats;
 
     int *evalStack;
     int _evalStack[MAX_PLY+4];
@@ -53,11 +89,9 @@ struct Thread {
 
     jmp_buf jbuffer;
 
-    int index;
-    int nthreads;
-    Thread* threads;
-
     PawnKingTable pktable;
+    EvalCache evcache;
+    MaterialTable mtable;
     KillerTable killers;
     CounterMoveTable cmtable;
     HistoryTable history;
@@ -66,10 +100,15 @@ struct Thread {
 
 
 Thread* createThreadPool(int nthreads);
+void deleteThreadPool(Thread* threads);
 void resetThreadPool(Thread* threads);
 void newSearchThreadPool(Thread* threads, Board* board, Limits* limits, SearchInfo* info);
+void startSearchThreadPool(Thread* threads);
+void waitSearchThreadPool(Thread* threads);
+void runThreadPool(Thread* threads, void (*task)(Thread*));
 
 uint64_t nodesSearchedThreadPool(Thread* threads);
 uint64_t tbhitsSearchedThreadPool(Thread* threads);
+void ttstatsThreadPool(Thread* threads, TTStats* stats);
 
 #endif
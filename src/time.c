@@ -18,11 +18,11 @@
 
 #if defined(_WIN32) || defined(_WIN64)
     #include <windows.h>
-#else
-    #include <sys/time.h>
 #endif
 
+#include <pthread.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "search.h"
 #include "thread.h"
@@ -33,20 +33,100 @@
 
 int MoveOverhead = 100; // Set by UCI options
 
+volatile int TIME_EXPIRED; // Set by the timer thread at the deadline
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define TIMER_CLOCK CLOCK_REALTIME
+#else
+    #define TIMER_CLOCK CLOCK_MONOTONIC
+#endif
+
+static pthread_once_t TimerOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t TimerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t TimerWakeup;
+static pthread_t TimerThread;
+static double TimerDeadline; // In getRealTime() milliseconds
+static int TimerArmed;
+
 
 double getRealTime(){
 #if defined(_WIN32) || defined(_WIN64)
     return (double)(GetTickCount());
 #else
-    struct timeval tv;
-    double secsInMilli, usecsInMilli;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+static void* timerThreadLoop(void* unused){
+
+    struct timespec ts;
+    double remaining;
+
+    (void)unused;
+
+    pthread_mutex_lock(&TimerLock);
+
+    while (1) {
+
+        // Sleep until a search with a deadline arms the timer
+        while (!TimerArmed)
+            pthread_cond_wait(&TimerWakeup, &TimerLock);
+
+        // Deadline has passed, so let the searching threads know
+        if ((remaining = TimerDeadline - getRealTime()) <= 0) {
+            TIME_EXPIRED = 1;
+            TimerArmed = 0;
+            continue;
+        }
+
+        // Sleep until the deadline, or until disarmed or rearmed
+        clock_gettime(TIMER_CLOCK, &ts);
+        ts.tv_sec  += (time_t)(remaining / 1000);
+        ts.tv_nsec += (long)(1000000 * (remaining - 1000 * (time_t)(remaining / 1000)));
+        if (ts.tv_nsec >= 1000000000) { ts.tv_sec++; ts.tv_nsec -= 1000000000; }
+        pthread_cond_timedwait(&TimerWakeup, &TimerLock, &ts);
+    }
+
+    return NULL;
+}
 
-    gettimeofday(&tv, NULL);
-    secsInMilli = ((double)tv.tv_sec) * 1000;
-    usecsInMilli = tv.tv_usec / 1000;
+static void initTimerThread(){
 
-    return secsInMilli + usecsInMilli;
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_condattr_setclock(&attr, TIMER_CLOCK);
 #endif
+    pthread_cond_init(&TimerWakeup, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_create(&TimerThread, NULL, &timerThreadLoop, NULL);
+}
+
+void startSearchTimer(SearchInfo* info, Limits* limits){
+
+    pthread_once(&TimerOnce, initTimerThread);
+
+    pthread_mutex_lock(&TimerLock);
+
+    TIME_EXPIRED = 0;
+
+    // Only arm the timer when the search has a time based deadline
+    TimerArmed = limits->limitedBySelf || limits->limitedByTime;
+    TimerDeadline = info->startTime + info->maxUsage;
+
+    pthread_cond_signal(&TimerWakeup);
+    pthread_mutex_unlock(&TimerLock);
+}
+
+void stopSearchTimer(){
+    pthread_mutex_lock(&TimerLock);
+    TimerArmed = 0;
+    pthread_cond_signal(&TimerWakeup);
+    pthread_mutex_unlock(&TimerLock);
 }
 
 double elapsedTime(SearchInfo* info){
@@ -140,16 +220,28 @@ int terminateTimeManagment(SearchInfo* info) {
     return elapsedTime(info) > MIN(cutoff, info->maxAlloc);
 }
 
-int terminateSearchEarly(Thread *thread) {
-
-    // Terminate the search early if the max usage time has passed.
-    // Only check this once for every 1024 nodes examined. Never
-    // take an early exit before a depth one search has finished
+int terminateNodeLimit(Thread *thread) {
 
     const Limits *limits = thread->limits;
 
-    return  thread->depth > 1
-        && (thread->nodes & 1023) == 1023
-        && (limits->limitedBySelf || limits->limitedByTime)
-        &&  elapsedTime(thread->info) >= thread->info->maxUsage;
+    // Only the main thread checks, and helpers are stopped along with it
+    if (!limits->limitedByNodes || thread->index != 0)
+        return 0;
+
+    // A single thread can compare its own counter exactly, every node
+    if (thread->nthreads == 1)
+        return relaxedLoad(thread->nodes) >= limits->nodeLimit;
+
+    // Otherwise, sum over the whole pool once for every 1024 nodes
+    return (relaxedLoad(thread->nodes) & 1023) == 0
+        &&  nodesSearchedThreadPool(thread->threads) >= limits->nodeLimit;
+}
+
+int terminateSearchEarly(Thread *thread) {
+
+    // Terminate the search early if the max usage time has passed, which
+    // the timer thread signals, or if the node budget has been spent.
+    // Never take an early exit before a depth one search has finished
+
+    return thread->depth > 1 && (TIME_EXPIRED || terminateNodeLimit(thread));
 }
\ No newline at end of file
@@ -26,7 +26,10 @@ double elapsedTime(SearchInfo* info);
 void initTimeManagment(SearchInfo* info, Limits* limits);
 void updateTimeManagment(SearchInfo* info, Limits* limits, int depth, int value);
 int terminateTimeManagment(SearchInfo* info);
+int terminateNodeLimit(Thread *thread);
 int terminateSearchEarly(Thread *thread);
+void startSearchTimer(SearchInfo* info, Limits* limits);
+void stopSearchTimer();
 
 static const double PVFactorCount  = 8;
 static const double PVFactorWeight = 0.085;
@@ -16,50 +16,174 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <assert.h>
 #include <string.h>
 
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include "move.h"
+#include "thread.h"
 #include "types.h"
 #include "transposition.h"
+#include "windows.h"
 
 TTable Table; // Global Transposition Table
 
-void initTT(uint64_t megabytes) {
+int HashPlacement = TT_PLACE_FIRST_TOUCH; // Set by UCI options
 
-    // Free up memory if we already allocated
-    if (Table.hashMask != 0ull) free(Table.buckets);
+int PawnHashMegabytes = 2; // Set by UCI options
+
+int PawnHashShared = 0; // Set by UCI options
+
+int EvalCacheMegabytes = 1; // Set by UCI options
+
+int ABDADAEnabled = 0; // Set by UCI options
+
+// Positions being searched by some thread, keyed by hash and depth
+static _Atomic uint64_t SearchingTable[SEARCHING_TABLE_SIZE];
+
+static uint64_t ttBucketIndex(uint64_t hash) {
+
+    // Map the lower 48 bits of the hash, which are independent of the
+    // 16 bit signature, onto [0, numBuckets) using a multiply-high
+    return ((unsigned __int128)(hash << 16) * Table.numBuckets) >> 64;
+}
+
+static void* allocTTBuckets(uint64_t bytes) {
+
+    void *memory;
+
+#if defined(__linux__)
+
+    // Huge page mappings must cover a whole number of pages
+    bytes = (bytes + TTHugePageSize - 1) / TTHugePageSize * TTHugePageSize;
+
+    // Try for explicitly reserved huge pages first. This will fail
+    // unless the system has set aside pages via vm.nr_hugepages
+    memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+        Table.pages = TT_PAGES_HUGETLB;
+        return memory;
+    }
+
+    // Otherwise align to 2MB and ask for transparent huge pages
+    #if defined(MADV_HUGEPAGE)
+    if (!posix_memalign(&memory, TTHugePageSize, bytes)) {
+        Table.pages = madvise(memory, bytes, MADV_HUGEPAGE) ? TT_PAGES_NORMAL : TT_PAGES_TRANSPARENT;
+        return memory;
+    }
+    #endif
+
+#endif
+
+    // Fallback to normal pages from the heap
+    memory = malloc(bytes);
+    Table.pages = TT_PAGES_NORMAL;
+    return memory;
+}
 
-    // We set the smallest TT to 1 MB. This is a TT with a lookup
-    // key with 15 bits. We start with 16 bits, because the scaling
-    // ends by decrementing the key size by 1 bit.
-    uint64_t keySize = 16ull;
+static void freeTTBuckets(void *memory, uint64_t bytes) {
 
-    // Buckets must be 32 bytes for the scaling and for alignment
+#if defined(__linux__)
+    if (Table.pages == TT_PAGES_HUGETLB) {
+        bytes = (bytes + TTHugePageSize - 1) / TTHugePageSize * TTHugePageSize;
+        munmap(memory, bytes);
+        return;
+    }
+#endif
+
+    (void)bytes; free(memory);
+}
+
+void initTT(uint64_t megabytes, Thread* threads) {
+
+    // Buckets must be 32 bytes for the sizing and for alignment
     assert(sizeof(TTBucket) == 32);
 
-    // Scale down the table to the closest power of 2, at or below megabytes
-    for (;1ull << (keySize + 5) <= megabytes << 20 ; keySize++);
-    keySize -= 1;
+    // Use every byte we were given, rather than scaling down to a power
+    // of two. The smallest TT is 1 MB, which avoids a degenerate table
+    const uint64_t numBuckets = (MAX(1ull, megabytes) << 20) / sizeof(TTBucket);
+
+    // Keep the existing table and its contents if nothing has changed
+    if (Table.numBuckets == numBuckets && Table.placement == HashPlacement)
+        return;
+
+    // Free up memory if we already allocated
+    if (Table.numBuckets != 0ull)
+        freeTTBuckets(Table.buckets, Table.numBuckets * sizeof(TTBucket));
+
+    // Allocate all of our TTBuckets and TTEntries, huge pages when possible
+    Table.buckets    = allocTTBuckets(numBuckets * sizeof(TTBucket));
+    Table.numBuckets = numBuckets;
+
+    // Spread the pages over all nodes if requested and possible. Otherwise
+    // the pages land on the node of the thread in clearTT() that touches them
+    Table.placement   = HashPlacement;
+    Table.interleaved = HashPlacement == TT_PLACE_INTERLEAVE
+                     && interleaveMemory(Table.buckets, numBuckets * sizeof(TTBucket));
+
+    // Reset the TT for a new search. This is also the first touch
+    // of the memory, so the pages are faulted in by the thread pool
+    clearTT(threads);
+}
+
+const char* pagesUsedTT() {
 
-    // Allocate all of our TTBuckets and TTEntries
-    Table.buckets = malloc((1ull << keySize) * sizeof(TTBucket));
+    static const char *names[] = {
+        "normal pages", "transparent huge pages", "reserved huge pages"
+    };
 
-    // We lookup the table with the lowest keySize bits of a hash
-    Table.hashMask   = (1ull << keySize) - 1u;
+    return names[Table.pages];
+}
 
-    clearTT(); // Reset the TT for a new search
+const char* placementUsedTT() {
+    return Table.interleaved
+         ? "interleaved across NUMA nodes" : "placed by first touch";
 }
 
 void updateTT() {
     Table.generation += 4; // Pad lower bits for bounds
 }
 
-void clearTT() {
-    memset(Table.buckets, 0, sizeof(TTBucket) * (Table.hashMask + 1u));
+static void clearTTSlice(Thread* thread) {
+
+    // Each slice is a contiguous run of whole buckets
+    const uint64_t buckets = Table.numBuckets;
+    const uint64_t start   = buckets * thread->index / thread->nthreads;
+    const uint64_t end     = buckets * (thread->index + 1) / thread->nthreads;
+
+    // Bind the same way the search will, so the pages
+    // are first touched on the node of the owning thread
+    if (thread->nthreads > 8)
+        bindThisThread(thread->index);
+
+    memset(&Table.buckets[start], 0, sizeof(TTBucket) * (end - start));
+}
+
+void clearTT(Thread* threads) {
+
+    // Without a pool, such as during startup, clear from this thread
+    if (threads == NULL) {
+        memset(Table.buckets, 0, sizeof(TTBucket) * Table.numBuckets);
+        return;
+    }
+
+    // Otherwise each Thread in the pool clears its own slice, so the
+    // pages are touched by the same threads which will search them
+    runThreadPool(threads, &clearTTSlice);
 }
 
 int hashfullTT() {
@@ -75,25 +199,162 @@ int hashfullTT() {
     return used / 3;
 }
 
+static void initTTFileHeader(TTFileHeader *header) {
+
+    // Record everything needed to know if the saved buckets
+    // can be read back by the current build and table layout
+    memset(header, 0, sizeof(TTFileHeader));
+    memcpy(header->magic, TTFileMagic, sizeof(TTFileMagic));
+    header->version       = TTFileVersion;
+    header->bucketSize    = sizeof(TTBucket);
+    header->signatureBits = 16;
+    header->generation    = Table.generation;
+    header->numBuckets    = Table.numBuckets;
+}
+
+int saveTT(const char *path) {
+
+    TTFileHeader header;
+    initTTFileHeader(&header);
+
+    const uint64_t bytes = sizeof(TTFileHeader) + Table.numBuckets * sizeof(TTBucket);
+
+#if defined(_WIN32) || defined(_WIN64)
+
+    FILE *fout = fopen(path, "wb");
+    if (fout == NULL) return 0;
+
+    int success =  fwrite(&header, sizeof(TTFileHeader), 1, fout) == 1
+               &&  fwrite(Table.buckets, sizeof(TTBucket), Table.numBuckets, fout) == Table.numBuckets;
+
+    return !fclose(fout) && success;
+
+#else
+
+    // Size the file up front, and then map it so that
+    // the table can be copied out at disk bandwidth
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return 0;
+
+    if (ftruncate(fd, bytes) == -1) { close(fd); return 0; }
+
+    char *file = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (file == MAP_FAILED) { close(fd); return 0; }
+
+    memcpy(file, &header, sizeof(TTFileHeader));
+    memcpy(file + sizeof(TTFileHeader), Table.buckets, Table.numBuckets * sizeof(TTBucket));
+
+    munmap(file, bytes);
+    return !close(fd);
+
+#endif
+}
+
+int loadTT(const char *path, Thread* threads) {
+
+    TTFileHeader header, expected;
+
+#if defined(_WIN32) || defined(_WIN64)
+
+    FILE *fin = fopen(path, "rb");
+    if (fin == NULL) return 0;
+
+    if (fread(&header, sizeof(TTFileHeader), 1, fin) != 1) { fclose(fin); return 0; }
+
+#else
+
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return 0;
+
+    if (fstat(fd, &st) == -1 || (uint64_t)st.st_size < sizeof(TTFileHeader)) { close(fd); return 0; }
+
+    char *file = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (file == MAP_FAILED) { close(fd); return 0; }
+
+    memcpy(&header, file, sizeof(TTFileHeader));
+
+#endif
+
+    // The file must have been written by a compatible build. The
+    // bucket count is allowed to differ, as we will resize to match
+    initTTFileHeader(&expected);
+    int compatible =  !memcmp(header.magic, expected.magic, sizeof(TTFileMagic))
+                   &&  header.version       == expected.version
+                   &&  header.bucketSize    == expected.bucketSize
+                   &&  header.signatureBits == expected.signatureBits
+                   &&  header.numBuckets * sizeof(TTBucket) % (1ull << 20) == 0
+                   &&  header.numBuckets > 0;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    compatible = compatible && (uint64_t)st.st_size ==
+        sizeof(TTFileHeader) + header.numBuckets * sizeof(TTBucket);
+#endif
+
+    if (compatible) {
+
+        // Resize to the saved table, and continue the saved generations
+        initTT((header.numBuckets * sizeof(TTBucket)) >> 20, threads);
+        Table.generation = header.generation;
+
+#if defined(_WIN32) || defined(_WIN64)
+        compatible = fread(Table.buckets, sizeof(TTBucket), Table.numBuckets, fin) == Table.numBuckets;
+        if (!compatible) clearTT(threads);
+#else
+        memcpy(Table.buckets, file + sizeof(TTFileHeader), Table.numBuckets * sizeof(TTBucket));
+#endif
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    fclose(fin);
+#else
+    munmap(file, st.st_size);
+    close(fd);
+#endif
+
+    // Report the size of the loaded table, so the caller can track it
+    return compatible ? (int)((Table.numBuckets * sizeof(TTBucket)) >> 20) : 0;
+}
+
+static uint16_t ttEntryChecksum(const TTEntry *entry) {
+
+    // Fold the payload of an entry into 16 bits. The generation is
+    // excluded, save for the bound, since probes refresh the age in place
+    return entry->move
+         ^ (uint16_t)entry->value
+         ^ (uint16_t)entry->eval
+         ^ (uint16_t)(((uint8_t)entry->depth << 8) | (entry->generation & 0x3));
+}
+
+static uint16_t ttEntryHash16(const TTEntry *entry) {
+
+    // Entries store their signature XOR'ed with the checksum of their payload,
+    // so an entry torn by two writers will almost never decode to a valid key
+    return entry->hash16 ^ ttEntryChecksum(entry);
+}
+
 int getTTEntry(uint64_t hash, uint16_t *move, int *value, int *eval, int *depth, int *bound) {
 
     const uint16_t hash16 = hash >> 48;
-    TTEntry *slots = &Table.buckets[hash & Table.hashMask].slots[0];
+    TTEntry entry, *slots = &Table.buckets[ttBucketIndex(hash)].slots[0];
 
     // Search for a matching hash signature
     for (int i = 0; i < 3; i++) {
 
-        if (slots[i].hash16 == hash16) {
+        // Work from a private copy, as other threads may write concurrently
+        entry = slots[i];
+
+        if (ttEntryHash16(&entry) == hash16) {
 
             // Update age, retain the bounds stored in the lower two bits
-            slots[i].generation = Table.generation | (slots[i].generation & 0x3);
+            slots[i].generation = Table.generation | (entry.generation & 0x3);
 
             // Copy over the TTEntry and signal success
-            *move  = slots[i].move;
-            *value = slots[i].value;
-            *eval  = slots[i].eval;
-            *depth = slots[i].depth;
-            *bound = slots[i].generation & 0x3;
+            *move  = entry.move;
+            *value = entry.value;
+            *eval  = entry.eval;
+            *depth = entry.depth;
+            *bound = entry.generation & 0x3;
             return 1;
         }
     }
@@ -101,7 +362,7 @@ int getTTEntry(uint64_t hash, uint16_t *move, int *value, int *eval, int *depth,
     return 0; // No TTEntry found
 }
 
-void storeTTEntry(uint64_t hash, uint16_t move, int value, int eval, int depth, int bound) {
+int storeTTEntry(uint64_t hash, uint16_t move, int value, int eval, int depth, int bound) {
 
     assert(abs(value) <= MATE);
     assert(abs(eval) <= MATE || eval == VALUE_NONE);
@@ -109,52 +370,273 @@ void storeTTEntry(uint64_t hash, uint16_t move, int value, int eval, int depth,
     assert(bound == BOUND_LOWER || bound == BOUND_UPPER || bound == BOUND_EXACT);
 
     const uint16_t hash16 = hash >> 48;
-    TTEntry *replace = NULL, *slots = &Table.buckets[hash & Table.hashMask].slots[0];
+    TTEntry *slots = &Table.buckets[ttBucketIndex(hash)].slots[0];
+    TTEntry entries[3], *replace = NULL, entry;
+    int result;
+
+    // Work from a private copy, as other threads may write concurrently
+    memcpy(entries, slots, sizeof(entries));
 
     for (int i = 0; i < 3; i++) {
 
         // Found a matching hash or an unused entry
-        if (slots[i].hash16 == hash16 || (slots[i].generation & 0x3) == 0u) {
-            replace = &slots[i];
+        if (ttEntryHash16(&entries[i]) == hash16 || (entries[i].generation & 0x3) == 0u) {
+            replace = &entries[i];
             break;
          }
 
         // Take the first entry as a starting point
         if (i == 0) {
-            replace = &slots[i];
+            replace = &entries[i];
             continue;
         }
 
         // Replace using MAX(x1, x2), where xN = depth - 8 * age difference
         if (   replace->depth - ((259 + Table.generation - replace->generation) & 0xFC) * 2
-            >= slots[i].depth - ((259 + Table.generation - slots[i].generation) & 0xFC) * 2)
-            replace = &slots[i];
+            >= entries[i].depth - ((259 + Table.generation - entries[i].generation) & 0xFC) * 2)
+            replace = &entries[i];
     }
 
     // Don't overwrite an entry from the same position, unless we have
     // an exact bound or depth that is nearly as good as the old one
     if (    bound != BOUND_EXACT
-        &&  hash16 == replace->hash16
+        &&  hash16 == ttEntryHash16(replace)
         &&  depth < replace->depth - 3)
+        return TT_STORE_SKIPPED;
+
+    // Classify the store for the instrumentation counters
+    if ((replace->generation & 0x3) == 0u)
+        result = TT_STORE_EMPTY;
+    else if (hash16 == ttEntryHash16(replace))
+        result = TT_STORE_UPDATE;
+    else
+        result = TT_STORE_REPLACE
+               | ((replace->generation & 0xFC) != Table.generation ? TT_STORE_STALE  : 0)
+               | (replace->depth > depth                           ? TT_STORE_DEEPER : 0);
+
+    // Build the new entry, and sign it with the checksum of the payload
+    entry.depth      = (int8_t)depth;
+    entry.generation = (uint8_t)bound | Table.generation;
+    entry.value      = (int16_t)value;
+    entry.eval       = (int16_t)eval;
+    entry.move       = (uint16_t)move;
+    entry.hash16     = (uint16_t)hash16 ^ ttEntryChecksum(&entry);
+
+    // Finally, copy the new entry into the replaced slot in one go
+    slots[replace - entries] = entry;
+
+    return result;
+}
+
+void recordTTStore(TTStats *stats, int result) {
+
+#if defined(TTSTATS)
+    stats->stores += result != TT_STORE_SKIPPED;
+    if (result & TT_STORE_REPLACE)
+        stats->replaced[!!(result & TT_STORE_STALE)][!!(result & TT_STORE_DEEPER)]++;
+#else
+    (void)stats; (void)result;
+#endif
+}
+
+void mergeTTStats(TTStats *total, TTStats *stats) {
+
+    total->probes       += stats->probes;
+    total->hits         += stats->hits;
+    total->cutoffs      += stats->cutoffs;
+    total->falseMatches += stats->falseMatches;
+    total->stores       += stats->stores;
+
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            total->replaced[i][j] += stats->replaced[i][j];
+}
+
+void reportTableStats(Thread *threads) {
+
+    uint64_t pkprobes = 0ull, pkhits = 0ull;
+    uint64_t evprobes = 0ull, evhits = 0ull;
+
+    for (int i = 0; i < threads[0].nthreads; i++) {
+        pkprobes += threads[i].pktable.probes;
+        pkhits   += threads[i].pktable.hits;
+        evprobes += threads[i].evcache.probes;
+        evhits   += threads[i].evcache.hits;
+    }
+
+    printf("info string pkstats probes %"PRIu64" hits %"PRIu64" (%.1f%%)\n",
+           pkprobes, pkhits, 100.0 * pkhits / MAX(1.0, (double)pkprobes));
+
+    printf("info string evstats probes %"PRIu64" hits %"PRIu64" (%.1f%%)\n",
+           evprobes, evhits, 100.0 * evhits / MAX(1.0, (double)evprobes));
+
+    fflush(stdout);
+}
+
+void reportTTStats(TTStats *stats) {
+
+    // Percentages are relative to the number of probes
+    double probes = MAX(1.0, (double)stats->probes);
+
+    printf("info string ttstats probes %"PRIu64" hits %"PRIu64" (%.1f%%) "
+           "cutoffs %"PRIu64" (%.1f%%) falsematches %"PRIu64" stores %"PRIu64"\n",
+           stats->probes, stats->hits, 100.0 * stats->hits / probes,
+           stats->cutoffs, 100.0 * stats->cutoffs / probes,
+           stats->falseMatches, stats->stores);
+
+    printf("info string ttstats replaced current/shallower %"PRIu64" current/deeper %"PRIu64" "
+           "stale/shallower %"PRIu64" stale/deeper %"PRIu64"\n",
+           stats->replaced[0][0], stats->replaced[0][1],
+           stats->replaced[1][0], stats->replaced[1][1]);
+
+    fflush(stdout);
+}
+
+void prefetchTTEntry(uint64_t hash) {
+#if !defined(NO_PREFETCH)
+    __builtin_prefetch(&Table.buckets[ttBucketIndex(hash)]);
+#else
+    (void)hash;
+#endif
+}
+
+static uint64_t pkEntryIndex(PawnKingTable *pktable, uint64_t pkhash) {
+    return ((unsigned __int128)pkhash * pktable->numEntries) >> 64;
+}
+
+void initPawnKingTable(PawnKingTable *pktable, PawnKingTable *shared) {
+
+    // Clear out the hit rate counters for this thread
+    memset(pktable, 0, sizeof(PawnKingTable));
+
+    // Borrow the entries of another thread's table when sharing
+    if (shared != NULL) {
+        pktable->entries    = shared->entries;
+        pktable->numEntries = shared->numEntries;
+        pktable->shared     = 1;
         return;
+    }
 
-    // Finally, copy the new data into the replaced slot
-    replace->depth      = (int8_t)depth;
-    replace->generation = (uint8_t)bound | Table.generation;
-    replace->value      = (int16_t)value;
-    replace->eval       = (int16_t)eval;
-    replace->move       = (uint16_t)move;
-    replace->hash16     = (uint16_t)hash16;
+    // Otherwise allocate our own table, sized by the UCI options
+    pktable->numEntries = (MAX(1, PawnHashMegabytes) << 20) / sizeof(PawnKingEntry);
+    pktable->entries    = calloc(pktable->numEntries, sizeof(PawnKingEntry));
 }
 
-PawnKingEntry* getPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash) {
-    PawnKingEntry *pkentry = &pktable->entries[pkhash >> 48];
-    return pkentry->pkhash == pkhash ? pkentry : NULL;
+void clearPawnKingTable(PawnKingTable *pktable) {
+    if (!pktable->shared)
+        memset(pktable->entries, 0, sizeof(PawnKingEntry) * pktable->numEntries);
+}
+
+void freePawnKingTable(PawnKingTable *pktable) {
+    if (!pktable->shared)
+        free(pktable->entries);
+}
+
+PawnKingEntry* getPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash, PawnKingEntry *pkentry) {
+
+    // Work from a private copy, as the entries may be shared between threads
+    *pkentry = pktable->entries[pkEntryIndex(pktable, pkhash)];
+    TTStat(pktable, probes);
+
+    // Entries store their key XOR'ed with their payload, to reject torn entries
+    if ((pkentry->pkhash ^ pkentry->passed ^ (uint64_t)pkentry->eval) != pkhash)
+        return NULL;
+
+    TTStat(pktable, hits);
+    return pkentry;
 }
 
 void storePawnKingEntry(PawnKingTable *pktable, uint64_t pkhash, uint64_t passed, int eval) {
-    PawnKingEntry *pkentry = &pktable->entries[pkhash >> 48];
-    pkentry->pkhash = pkhash;
-    pkentry->passed = passed;
-    pkentry->eval   = eval;
+
+    PawnKingEntry pkentry;
+
+    pkentry.pkhash = pkhash ^ passed ^ (uint64_t)eval;
+    pkentry.passed = passed;
+    pkentry.eval   = eval;
+
+    pktable->entries[pkEntryIndex(pktable, pkhash)] = pkentry;
+}
+
+void prefetchPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash) {
+#if !defined(NO_PREFETCH)
+    __builtin_prefetch(&pktable->entries[pkEntryIndex(pktable, pkhash)]);
+#else
+    (void)pktable; (void)pkhash;
+#endif
+}
+
+MaterialEntry* getMaterialEntry(MaterialTable *mtable, uint64_t mhash) {
+    MaterialEntry *mentry = &mtable->entries[mhash >> 52];
+    return mentry->mhash == mhash ? mentry : NULL;
+}
+
+void storeMaterialEntry(MaterialTable *mtable, MaterialEntry *mentry) {
+    mtable->entries[mentry->mhash >> 52] = *mentry;
+}
+
+static uint64_t searchingKey(uint64_t hash, int depth) {
+    return (hash & ~0xFFull) | (uint64_t)(depth & 0xFF);
+}
+
+void clearSearchingTable() {
+    for (int i = 0; i < SEARCHING_TABLE_SIZE; i++)
+        atomic_store_explicit(&SearchingTable[i], 0ull, memory_order_relaxed);
+}
+
+int isSearchingTable(uint64_t hash, int depth) {
+    const uint64_t key = searchingKey(hash, depth);
+    return atomic_load_explicit(&SearchingTable[key % SEARCHING_TABLE_SIZE], memory_order_relaxed) == key;
+}
+
+void markSearchingTable(uint64_t hash, int depth) {
+
+    // Lossy by design, a collision only causes another thread to defer
+    // a move which it did not need to, or to not defer one it could have
+    const uint64_t key = searchingKey(hash, depth);
+    atomic_store_explicit(&SearchingTable[key % SEARCHING_TABLE_SIZE], key, memory_order_relaxed);
+}
+
+void unmarkSearchingTable(uint64_t hash, int depth) {
+    const uint64_t key = searchingKey(hash, depth);
+    uint64_t expected = key;
+    atomic_compare_exchange_strong_explicit(&SearchingTable[key % SEARCHING_TABLE_SIZE],
+        &expected, 0ull, memory_order_relaxed, memory_order_relaxed);
+}
+
+static uint64_t evEntryIndex(EvalCache *evcache, uint64_t hash) {
+    return ((hash & 0xFFFFFFFFull) * evcache->numEntries) >> 32;
+}
+
+void initEvalCache(EvalCache *evcache) {
+    memset(evcache, 0, sizeof(EvalCache));
+    evcache->numEntries = (MAX(1, EvalCacheMegabytes) << 20) / sizeof(EvalCacheEntry);
+    evcache->entries    = calloc(evcache->numEntries, sizeof(EvalCacheEntry));
+}
+
+void clearEvalCache(EvalCache *evcache) {
+    memset(evcache->entries, 0, sizeof(EvalCacheEntry) * evcache->numEntries);
+}
+
+void freeEvalCache(EvalCache *evcache) {
+    free(evcache->entries);
+}
+
+int getEvalCacheEntry(EvalCache *evcache, uint64_t hash, int *eval) {
+
+    // The lower half of the hash selects the slot, the upper half verifies it
+    EvalCacheEntry *entry = &evcache->entries[evEntryIndex(evcache, hash)];
+    TTStat(evcache, probes);
+
+    if (entry->hash32 != (uint32_t)(hash >> 32))
+        return 0;
+
+    TTStat(evcache, hits);
+    *eval = entry->eval;
+    return 1;
+}
+
+void storeEvalCacheEntry(EvalCache *evcache, uint64_t hash, int eval) {
+    EvalCacheEntry *entry = &evcache->entries[evEntryIndex(evcache, hash)];
+    entry->hash32 = (uint32_t)(hash >> 32);
+    entry->eval   = eval;
 }
@@ -23,6 +23,30 @@
 
 #include "types.h"
 
+enum {
+    TT_PAGES_NORMAL      = 0,
+    TT_PAGES_TRANSPARENT = 1,
+    TT_PAGES_HUGETLB     = 2,
+};
+
+enum {
+    TT_PLACE_FIRST_TOUCH = 0,
+    TT_PLACE_INTERLEAVE  = 1,
+};
+
+enum {
+    TT_STORE_SKIPPED = 0,
+    TT_STORE_EMPTY   = 1,
+    TT_STORE_UPDATE  = 2,
+    TT_STORE_REPLACE = 4,
+    TT_STORE_STALE   = 8,
+    TT_STORE_DEEPER  = 16,
+};
+
+enum {
+    SEARCHING_TABLE_SIZE = 0x2000,
+};
+
 enum {
     BOUND_NONE  = 0,
     BOUND_LOWER = 1,
@@ -36,7 +60,7 @@ struct TTEntry {
     int16_t eval;
     int16_t value;
     uint16_t move;
-    uint16_t hash16;
+    uint16_t hash16; // Signature XOR'ed with a payload checksum
 };
 
 struct TTBucket {
@@ -47,7 +71,28 @@ struct TTBucket {
 struct TTable {
     TTBucket *buckets;
     uint8_t generation;
-    uint64_t hashMask;
+    uint64_t numBuckets;
+    int pages;
+    int placement;
+    int interleaved;
+};
+
+struct TTFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucketSize;
+    uint32_t signatureBits;
+    uint32_t generation;
+    uint64_t numBuckets;
+};
+
+struct TTStats {
+    uint64_t probes;
+    uint64_t hits;
+    uint64_t cutoffs;
+    uint64_t falseMatches;
+    uint64_t stores;
+    uint64_t replaced[2][2]; // [Stale Victim][Deeper Victim]
 };
 
 struct PawnKingEntry {
@@ -57,17 +102,84 @@ struct PawnKingEntry {
 };
 
 struct PawnKingTable {
-    PawnKingEntry entries[0x10000];
+    PawnKingEntry *entries;
+    uint64_t numEntries;
+    int shared;
+    uint64_t probes;
+    uint64_t hits;
 };
 
-void initTT(uint64_t megabytes);
+struct EvalCacheEntry {
+    uint32_t hash32;
+    int32_t eval;
+};
+
+struct EvalCache {
+    EvalCacheEntry *entries;
+    uint64_t numEntries;
+    uint64_t probes;
+    uint64_t hits;
+};
+
+struct MaterialEntry {
+    uint64_t mhash;
+    int phase;
+    int scale;
+    int imbalance;
+};
+
+struct MaterialTable {
+    MaterialEntry entries[0x1000];
+};
+
+// Instrumentation is only compiled in when building with -DTTSTATS
+#if defined(TTSTATS)
+    #define TTStat(stats, field) ((stats)->field++)
+#else
+    #define TTStat(stats, field) ((void)0)
+#endif
+
+static const uint64_t TTHugePageSize = 2ull << 20;
+
+static const char TTFileMagic[8] = "ETHERTT";
+static const uint32_t TTFileVersion = 1;
+
+void initTT(uint64_t megabytes, Thread* threads);
+const char* pagesUsedTT();
+const char* placementUsedTT();
 void updateTT();
-void clearTT();
+void clearTT(Thread* threads);
 int hashfullTT();
+int saveTT(const char *path);
+int loadTT(const char *path, Thread* threads);
 int getTTEntry(uint64_t hash, uint16_t *move, int *value, int *eval, int *depth, int *bound);
-void storeTTEntry(uint64_t hash, uint16_t move, int value, int eval, int depth, int bound);
+int storeTTEntry(uint64_t hash, uint16_t move, int value, int eval, int depth, int bound);
+void prefetchTTEntry(uint64_t hash);
 
-PawnKingEntry* getPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash);
+void recordTTStore(TTStats *stats, int result);
+void mergeTTStats(TTStats *total, TTStats *stats);
+void reportTTStats(TTStats *stats);
+
+void initPawnKingTable(PawnKingTable *pktable, PawnKingTable *shared);
+void clearPawnKingTable(PawnKingTable *pktable);
+void freePawnKingTable(PawnKingTable *pktable);
+void reportTableStats(Thread *threads);
+PawnKingEntry* getPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash, PawnKingEntry *pkentry);
 void storePawnKingEntry(PawnKingTable *pktable, uint64_t pkhash, uint64_t passed, int eval);
+void prefetchPawnKingEntry(PawnKingTable *pktable, uint64_t pkhash);
+
+MaterialEntry* getMaterialEntry(MaterialTable *mtable, uint64_t mhash);
+void storeMaterialEntry(MaterialTable *mtable, MaterialEntry *mentry);
+
+void clearSearchingTable();
+int isSearchingTable(uint64_t hash, int depth);
+void markSearchingTable(uint64_t hash, int depth);
+void unmarkSearchingTable(uint64_t hash, int depth);
+
+void initEvalCache(EvalCache *evcache);
+void clearEvalCache(EvalCache *evcache);
+void freeEvalCache(EvalCache *evcache);
+int getEvalCacheEntry(EvalCache *evcache, uint64_t hash, int *eval);
+void storeEvalCacheEntry(EvalCache *evcache, uint64_t hash, int eval);
 
 #endif
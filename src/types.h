@@ -96,16 +96,24 @@ typedef struct Undo Undo;
 typedef struct EvalTrace EvalTrace;
 typedef struct EvalInfo EvalInfo;
 typedef struct MovePicker MovePicker;
+typedef struct CheckInfo CheckInfo;
 typedef struct SearchInfo SearchInfo;
 typedef struct PVariation PVariation;
+typedef struct RootMove RootMove;
 typedef struct TexelTuple TexelTuple;
 typedef struct TexelEntry TexelEntry;
 typedef struct Thread Thread;
 typedef struct TTEntry TTEntry;
 typedef struct TTBucket TTBucket;
 typedef struct TTable TTable;
+typedef struct TTStats TTStats;
+typedef struct TTFileHeader TTFileHeader;
 typedef struct PawnKingEntry PawnKingEntry;
 typedef struct PawnKingTable PawnKingTable;
+typedef struct EvalCacheEntry EvalCacheEntry;
+typedef struct EvalCache EvalCache;
+typedef struct MaterialEntry MaterialEntry;
+typedef struct MaterialTable MaterialTable;
 typedef struct Limits Limits;
 typedef struct ThreadsGo ThreadsGo;
 
@@ -46,6 +46,20 @@ extern int MoveOverhead; // Defined by Time.c
 
 extern unsigned TB_PROBE_DEPTH; // Defined by Syzygy.c
 
+extern int NumaBinding; // Defined by Windows.c
+
+extern int HashPlacement; // Defined by Transposition.c
+
+extern int PawnHashMegabytes; // Defined by Transposition.c
+
+extern int PawnHashShared; // Defined by Transposition.c
+
+extern int EvalCacheMegabytes; // Defined by Transposition.c
+
+extern int ABDADAEnabled; // Defined by Transposition.c
+
+extern int MultiPV; // Defined by Search.c
+
 extern volatile int ABORT_SIGNAL; // For killing active search
 
 extern volatile int IS_PONDERING; // For swapping out of PONDER
@@ -57,11 +71,12 @@ int main(int argc, char **argv) {
 
     Board board;
     char str[8192], *ptr;
-    ThreadsGo threadsgo;
+    ThreadsGo threadsgo = {0};
     pthread_t pthreadsgo;
 
     int nthreads = argc > 3 ? atoi(argv[3]) : 1;
     int megabytes = argc > 4 ? atoi(argv[4]) : 16;
+    int loaded;
 
     // Initialize the core components of Ethereal
     initAttacks();
@@ -70,25 +85,49 @@ int main(int argc, char **argv) {
     initZobrist();
     initSearch();
 
-    // Default to 16MB TT
-    initTT(megabytes);
-
     // Not required, but always setup the board from the starting position
     boardFromFEN(&board, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
     // Build our Thread Pool, with default size of 1-thread
     Thread* threads = createThreadPool(nthreads);
 
+    // Default to 16MB TT, first touched by the Thread Pool
+    initTT(megabytes, threads);
+
     #ifdef TUNE
         runTexelTuning(threads);
         exit(0);
     #endif
 
     if (argc > 1 && stringEquals(argv[1], "bench")) {
-        runBenchmark(threads, argc > 2 ? atoi(argv[2]) : 0);
+        runBenchmark(threads, argc > 2 ? atoi(argv[2]) : 0, argc > 5 ? atoll(argv[5]) : 0);
+        deleteThreadPool(threads);
         return 0;
     }
 
+    if (argc > 1 && stringEquals(argv[1], "scaling")) {
+        runScalingBenchmark(argc > 2 ? atoi(argv[2]) : 0, nthreads, megabytes);
+        deleteThreadPool(threads);
+        return 0;
+    }
+
+    if (argc > 2 && stringEquals(argv[1], "solve")) {
+        runSolveBenchmark(threads, argv[2], argc > 5 ? atoi(argv[5]) : 10000);
+        deleteThreadPool(threads);
+        return 0;
+    }
+
+    if (argc > 1 && stringEquals(argv[1], "latency")) {
+        runLatencyBenchmark(threads, argc > 2 ? atoi(argv[2]) : 1000);
+        deleteThreadPool(threads);
+        return 0;
+    }
+
+    // Searches are run by a single parked thread, woken for each go
+    pthread_mutex_init(&threadsgo.lock, NULL);
+    pthread_cond_init(&threadsgo.wakeup, NULL);
+    pthread_create(&pthreadsgo, NULL, &uciGoWorker, &threadsgo);
+
     while (1){
 
         getInput(str);
@@ -98,10 +137,17 @@ int main(int argc, char **argv) {
             printf("id author Andrew Grant & Laldon\n");
             printf("option name Hash type spin default 16 min 1 max 65536\n");
             printf("option name Threads type spin default 1 min 1 max 2048\n");
+            printf("option name PawnHash type spin default 2 min 1 max 1024\n");
+            printf("option name PawnHashShared type check default false\n");
+            printf("option name EvalCache type spin default 1 min 1 max 1024\n");
             printf("option name MoveOverhead type spin default 100 min 0 max 10000\n");
             printf("option name SyzygyPath type string default <empty>\n");
             printf("option name SyzygyProbeDepth type spin default 0 min 0 max 127\n");
             printf("option name Ponder type check default false\n");
+            printf("option name NumaBinding type check default true\n");
+            printf("option name HashPlacement type combo default FirstTouch var FirstTouch var Interleave\n");
+            printf("option name ABDADA type check default false\n");
+            printf("option name MultiPV type spin default 1 min 1 max 256\n");
             printf("uciok\n");
             fflush(stdout);
         }
@@ -117,17 +163,39 @@ int main(int argc, char **argv) {
 
             if (stringStartsWith(str, "setoption name Hash value ")){
                 megabytes = atoi(str + strlen("setoption name Hash value "));
-                initTT(megabytes);
+                initTT(megabytes, threads);
                 printf("info string set Hash to %dMB\n", megabytes);
+                printf("info string Hash is backed by %s\n", pagesUsedTT());
             }
 
             if (stringStartsWith(str, "setoption name Threads value ")){
-                free(threads);
+                deleteThreadPool(threads);
                 nthreads = atoi(str + strlen("setoption name Threads value "));
                 threads = createThreadPool(nthreads);
                 printf("info string set Threads to %d\n", nthreads);
             }
 
+            if (stringStartsWith(str, "setoption name PawnHash value ")){
+                deleteThreadPool(threads);
+                PawnHashMegabytes = atoi(str + strlen("setoption name PawnHash value "));
+                threads = createThreadPool(nthreads);
+                printf("info string set PawnHash to %dMB\n", PawnHashMegabytes);
+            }
+
+            if (stringStartsWith(str, "setoption name PawnHashShared value ")){
+                deleteThreadPool(threads);
+                PawnHashShared = stringEquals(str, "setoption name PawnHashShared value true");
+                threads = createThreadPool(nthreads);
+                printf("info string set PawnHashShared to %s\n", PawnHashShared ? "true" : "false");
+            }
+
+            if (stringStartsWith(str, "setoption name EvalCache value ")){
+                deleteThreadPool(threads);
+                EvalCacheMegabytes = atoi(str + strlen("setoption name EvalCache value "));
+                threads = createThreadPool(nthreads);
+                printf("info string set EvalCache to %dMB\n", EvalCacheMegabytes);
+            }
+
             if (stringStartsWith(str, "setoption name MoveOverhead value ")){
                 MoveOverhead = atoi(str + strlen("setoption name MoveOverhead value "));
                 printf("info string set MoveOverhead to %d\n", MoveOverhead);
@@ -143,22 +211,59 @@ int main(int argc, char **argv) {
                 printf("info string set SyzygyProbeDepth to %u\n", TB_PROBE_DEPTH);
             }
 
+            if (stringStartsWith(str, "setoption name HashPlacement value ")){
+                HashPlacement = stringEquals(str, "setoption name HashPlacement value Interleave")
+                              ? TT_PLACE_INTERLEAVE : TT_PLACE_FIRST_TOUCH;
+                initTT(megabytes, threads);
+                printf("info string Hash is %s\n", placementUsedTT());
+            }
+
+            if (stringStartsWith(str, "setoption name ABDADA value ")){
+                ABDADAEnabled = stringEquals(str, "setoption name ABDADA value true");
+                printf("info string set ABDADA to %s\n", ABDADAEnabled ? "true" : "false");
+            }
+
+            if (stringStartsWith(str, "setoption name MultiPV value ")){
+                MultiPV = MAX(1, MIN(MAX_MOVES, atoi(str + strlen("setoption name MultiPV value "))));
+                printf("info string set MultiPV to %d\n", MultiPV);
+            }
+
+            if (stringStartsWith(str, "setoption name NumaBinding value ")){
+                NumaBinding = stringEquals(str, "setoption name NumaBinding value true");
+                printf("info string set NumaBinding to %s\n", NumaBinding ? "true" : "false");
+            }
+
             fflush(stdout);
         }
 
         else if (stringEquals(str, "ucinewgame")){
             resetThreadPool(threads);
-            clearTT();
+            clearTT(threads);
         }
 
         else if (stringStartsWith(str, "position"))
             uciPosition(str, &board);
 
         else if (stringStartsWith(str, "go")){
+            // A go during a search, such as go infinite or a ponder search,
+            // acts as an implicit stop. Otherwise we would wait forever, and
+            // never read the stop or quit. A search which has already sent
+            // bestmove, but not yet finished, is simply waited out
+            pthread_mutex_lock(&threadsgo.lock);
+            if (threadsgo.searching){
+                ABORT_SIGNAL = 1;
+                IS_PONDERING = 0;
+            }
+            while (threadsgo.searching)
+                pthread_cond_wait(&threadsgo.wakeup, &threadsgo.lock);
+
             strncpy(threadsgo.str, str, 512);
             threadsgo.threads = threads;
             threadsgo.board = &board;
-            pthread_create(&pthreadsgo, NULL, &uciGo, &threadsgo);
+            threadsgo.searching = 1;
+            ABORT_SIGNAL = 0; // Cleared here, so an early stop is not lost
+            pthread_cond_signal(&threadsgo.wakeup);
+            pthread_mutex_unlock(&threadsgo.lock);
         }
 
         else if (stringEquals(str, "ponderhit"))
@@ -167,7 +272,10 @@ int main(int argc, char **argv) {
         else if (stringEquals(str, "stop")){
             ABORT_SIGNAL = 1;
             IS_PONDERING = 0;
-            pthread_join(pthreadsgo, NULL);
+            pthread_mutex_lock(&threadsgo.lock);
+            while (threadsgo.searching)
+                pthread_cond_wait(&threadsgo.wakeup, &threadsgo.lock);
+            pthread_mutex_unlock(&threadsgo.lock);
         }
 
         else if (stringEquals(str, "quit"))
@@ -178,6 +286,24 @@ int main(int argc, char **argv) {
             fflush(stdout);
         }
 
+        else if (stringStartsWith(str, "savehash ")){
+            ptr = str + strlen("savehash ");
+            if (saveTT(ptr)) printf("info string saved Hash to %s\n", ptr);
+            else printf("info string unable to save Hash to %s\n", ptr);
+            fflush(stdout);
+        }
+
+        else if (stringStartsWith(str, "loadhash ")){
+            ptr = str + strlen("loadhash ");
+            if ((loaded = loadTT(ptr, threads))) {
+                megabytes = loaded; // The table was resized to match the file
+                printf("info string loaded Hash from %s\n", ptr);
+                printf("info string set Hash to %dMB\n", megabytes);
+            }
+            else printf("info string unable to load Hash from %s\n", ptr);
+            fflush(stdout);
+        }
+
         else if (stringStartsWith(str, "print")){
             printBoard(&board);
             fflush(stdout);
@@ -187,6 +313,30 @@ int main(int argc, char **argv) {
     return 0;
 }
 
+void* uciGoWorker(void* vthreadsgo){
+
+    ThreadsGo* threadsgo = (ThreadsGo*) vthreadsgo;
+
+    pthread_mutex_lock(&threadsgo->lock);
+
+    while (1) {
+
+        // Sleep until the UCI thread hands us a go command
+        while (!threadsgo->searching)
+            pthread_cond_wait(&threadsgo->wakeup, &threadsgo->lock);
+
+        pthread_mutex_unlock(&threadsgo->lock);
+        uciGo(threadsgo);
+        pthread_mutex_lock(&threadsgo->lock);
+
+        // Let a waiting stop command know the search is finished
+        threadsgo->searching = 0;
+        pthread_cond_broadcast(&threadsgo->wakeup);
+    }
+
+    return NULL;
+}
+
 void* uciGo(void* vthreadsgo){
 
     // Get our starting time as soon as possible
@@ -201,16 +351,21 @@ void* uciGo(void* vthreadsgo){
 
     Limits limits; limits.start = start;
 
-    uint16_t bestMove, ponderMove;
-    char bestMoveStr[6], ponderMoveStr[6];
+    uint16_t bestMove, ponderMove, moves[MAX_MOVES];
+    char bestMoveStr[6], ponderMoveStr[6], moveStr[6];
 
-    int depth = -1, infinite = -1;
+    int depth = -1, infinite = -1, searchmoves = 0, size = 0;
+    int64_t nodes = -1;
     double wtime = -1, btime = -1, mtg = -1, movetime = -1;
     double winc = 0, binc = 0;
 
     // Reset pondering flag before starting search
     IS_PONDERING = 0;
 
+    // Legal moves, to match against any searchmoves
+    genAllLegalMoves(board, moves, &size);
+    limits.searchMovesSize = 0;
+
     // Init the tokenizer with spaces
     char* ptr = strtok(str, " ");
 
@@ -235,6 +390,9 @@ void* uciGo(void* vthreadsgo){
         else if (stringEquals(ptr, "depth"))
             depth = atoi(strtok(NULL, " "));
 
+        else if (stringEquals(ptr, "nodes"))
+            nodes = atoll(strtok(NULL, " "));
+
         else if (stringEquals(ptr, "movetime"))
             movetime = (double)(atoi(strtok(NULL, " ")));
 
@@ -243,15 +401,29 @@ void* uciGo(void* vthreadsgo){
 
         else if (stringEquals(ptr, "ponder"))
             IS_PONDERING = 1;
+
+        else if (stringEquals(ptr, "searchmoves"))
+            searchmoves = 1;
+
+        // Moves following searchmoves restrict the root
+        else if (searchmoves){
+            for (int i = 0; i < size; i++){
+                moveToString(moves[i], moveStr);
+                if (stringEquals(ptr, moveStr))
+                    limits.searchMoves[limits.searchMovesSize++] = moves[i];
+            }
+        }
     }
 
     // Initialize limits for the search
     limits.limitedByNone  = infinite != -1;
     limits.limitedByTime  = movetime != -1;
     limits.limitedByDepth = depth    != -1;
-    limits.limitedBySelf  = depth == -1 && movetime == -1 && infinite == -1;
+    limits.limitedByNodes = nodes    != -1;
+    limits.limitedBySelf  = depth == -1 && movetime == -1 && infinite == -1 && nodes == -1;
     limits.timeLimit      = movetime;
     limits.depthLimit     = depth;
+    limits.nodeLimit      = nodes;
 
     // Pick the time values for the colour we are playing as
     limits.time = (board->turn == WHITE) ? wtime : btime;
@@ -309,7 +481,7 @@ void uciPosition(char* str, Board* board){
 
         // Generate moves for this position
         size = 0;
-        genAllMoves(board, moves, &size);
+        genAllLegalMoves(board, moves, &size);
 
         // Move is in long algebraic notation
         move[0] = *ptr++; move[1] = *ptr++;
@@ -334,15 +506,13 @@ void uciPosition(char* str, Board* board){
     }
 }
 
-void uciReport(Thread* threads, int alpha, int beta, int value){
+void uciReport(Thread* thread, PVariation* pv, int depth, int line, int alpha, int beta, int value){
 
-    PVariation* pv  = &threads[0].pv;
     int hashfull    = hashfullTT();
-    int depth       = threads[0].depth;
-    int seldepth    = threads[0].seldepth;
-    int elapsed     = elapsedTime(threads[0].info);
-    uint64_t nodes  = nodesSearchedThreadPool(threads);
-    uint64_t tbhits = tbhitsSearchedThreadPool(threads);
+    int seldepth    = relaxedLoad(thread->seldepth);
+    int elapsed     = elapsedTime(thread->info);
+    uint64_t nodes  = nodesSearchedThreadPool(thread->threads);
+    uint64_t tbhits = tbhitsSearchedThreadPool(thread->threads);
     int nps         = (int)(1000 * (nodes / (1 + elapsed)));
 
     value = MAX(alpha, MIN(value, beta));
@@ -360,9 +530,14 @@ void uciReport(Thread* threads, int alpha, int beta, int value){
                 : value <= alpha ? " upperbound " : " ";
 
     // Main chunk of interface reporting
-    printf("info depth %d seldepth %d score %s %d%stime %d "
+    printf("info depth %d seldepth %d ", depth, seldepth);
+
+    // Number the lines when reporting more than one
+    if (MultiPV > 1) printf("multipv %d ", line + 1);
+
+    printf("score %s %d%stime %d "
            "nodes %"PRIu64" nps %d tbhits %"PRIu64" hashfull %d pv ",
-           depth, seldepth, type, score, bound, elapsed, nodes, nps, tbhits, hashfull);
+           type, score, bound, elapsed, nodes, nps, tbhits, hashfull);
 
     // Iterate over the PV and print each move
     for (int i = 0; i < pv->length; i++){
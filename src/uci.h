@@ -19,6 +19,8 @@
 #ifndef _UCI_H
 #define _UCI_H
 
+#include <pthread.h>
+
 #include "types.h"
 
 #define VERSION_ID "11.34"
@@ -38,6 +40,10 @@ struct Limits {
     int limitedByTime;
     int limitedByDepth;
     int limitedBySelf;
+    int limitedByNodes;
+    uint64_t nodeLimit;
+    int searchMovesSize;
+    uint16_t searchMoves[MAX_MOVES];
     double start;
     double time;
     double inc;
@@ -48,6 +54,9 @@ struct ThreadsGo {
     char str[512];
     Thread* threads;
     Board* board;
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+    int searching;
 };
 
 void getInput(char* str);
@@ -55,9 +64,10 @@ int stringEquals(char* s1, char* s2);
 int stringStartsWith(char* str, char* key);
 int stringContains(char* str, char* key);
 
-void* uciGo(void* vthreadgo);
+void* uciGoWorker(void* vthreadsgo);
+void* uciGo(void* vthreadsgo);
 void uciPosition(char* str, Board* board);
-void uciReport(Thread* threads, int alpha, int beta, int value);
+void uciReport(Thread* thread, PVariation* pv, int depth, int line, int alpha, int beta, int value);
 void uciReportTBRoot(uint16_t move, unsigned wdl, unsigned dtz);
 
 #endif
@@ -21,14 +21,196 @@
 #pragma GCC diagnostic ignored "-Wcast-function-type"
 #endif
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // For sched_setaffinity() and the CPU_SET macros
+#endif
+
 #include "windows.h"
 
+int NumaBinding = 1; // Set by UCI options
+
 #ifndef _WIN32
 
+#if defined(__linux__)
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum { MAX_NUMA_NODES = 64, MAX_NUMA_CPUS = CPU_SETSIZE };
+
+enum { MPOL_INTERLEAVE_MODE = 3 }; // From <linux/mempolicy.h>
+
+static int NumaNodeCount, NumaGroupSize;
+static int NumaNodeIds[MAX_NUMA_NODES];
+static int NumaGroups[MAX_NUMA_CPUS];
+static cpu_set_t NumaNodeMasks[MAX_NUMA_NODES];
+static pthread_once_t NumaOnce = PTHREAD_ONCE_INIT;
+
+/// readCpuList() parses a sysfs cpulist, such as "0-3,8-11", flagging
+/// each listed cpu when given an array. Returns the lowest cpu, or -1.
+
+static int readCpuList(const char *path, int *cpus) {
+
+    char buffer[4096], *ptr = buffer;
+    int first = -1, lo, hi, n;
+
+    FILE *fin = fopen(path, "r");
+    if (fin == NULL) return -1;
+
+    if (fgets(buffer, sizeof(buffer), fin) == NULL)
+        buffer[0] = '\0';
+    fclose(fin);
+
+    while (sscanf(ptr, "%d%n", &lo, &n) == 1) {
+
+        ptr += n; hi = lo;
+
+        // Ranges are given as lo-hi, single cpus just as lo
+        if (*ptr == '-' && sscanf(ptr + 1, "%d%n", &hi, &n) == 1)
+            ptr += n + 1;
+
+        for (int cpu = lo; cpus != NULL && cpu <= hi && cpu < MAX_NUMA_CPUS; cpu++)
+            cpus[cpu] = 1;
+
+        first = first == -1 ? lo : MIN(first, lo);
+        if (*ptr++ != ',') break;
+    }
+
+    return first;
+}
+
+/// initNumaGroups() reads the node and core topology from sysfs, without
+/// needing libnuma, and builds the node assignment for each thread index.
+
+static void initNumaGroups() {
+
+    char path[256];
+    int cores[MAX_NUMA_NODES], smts[MAX_NUMA_NODES];
+    struct dirent *entry;
+
+    // Collect the ids of all of the nodes known to the system
+    DIR *dir = opendir("/sys/devices/system/node");
+    while (dir != NULL && NumaNodeCount < MAX_NUMA_NODES && (entry = readdir(dir)) != NULL)
+        if (sscanf(entry->d_name, "node%d", &NumaNodeIds[NumaNodeCount]) == 1)
+            NumaNodeCount++;
+    if (dir != NULL) closedir(dir);
+
+    for (int n = 0; n < NumaNodeCount; n++) {
+
+        static int cpus[MAX_NUMA_CPUS];
+        memset(cpus, 0, sizeof(cpus));
+
+        cores[n] = smts[n] = 0;
+        CPU_ZERO(&NumaNodeMasks[n]);
+
+        sprintf(path, "/sys/devices/system/node/node%d/cpulist", NumaNodeIds[n]);
+        readCpuList(path, cpus);
+
+        // A cpu is a physical core if it is the first of its SMT siblings
+        for (int cpu = 0; cpu < MAX_NUMA_CPUS; cpu++) {
+
+            if (!cpus[cpu]) continue;
+
+            CPU_SET(cpu, &NumaNodeMasks[n]);
+
+            sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+            if (readCpuList(path, NULL) == cpu) cores[n]++; else smts[n]++;
+        }
+    }
+
+    // Binding only pays off when there is more than one node
+    if (NumaNodeCount <= 1)
+        return;
+
+    // Run as many threads as possible on the same node until
+    // core limit is reached, then move on filling the next node.
+    for (int n = 0; n < NumaNodeCount; n++)
+        for (int i = 0; i < cores[n]; i++)
+            NumaGroups[NumaGroupSize++] = n;
+
+    // Any remaining threads will use the SMT siblings, which we
+    // spread across the nodes that have them, one at a time
+    for (int added = 1; added; ) {
+        added = 0;
+        for (int n = 0; n < NumaNodeCount; n++) {
+            if (smts[n] > 0) {
+                NumaGroups[NumaGroupSize++] = n;
+                smts[n]--; added = 1;
+            }
+        }
+    }
+}
+
+/// bindThisThread() sets the cpu affinity of the current thread to
+/// every cpu found on the NUMA node chosen for the given index.
+
+void bindThisThread(int index) {
+
+    // Binding may be disabled by the UCI options
+    if (!NumaBinding)
+        return;
+
+    // Read the topology once, even if many threads bind at once
+    pthread_once(&NumaOnce, initNumaGroups);
+
+    // If we have more threads than the total number of logical
+    // processors then let the OS decide what to do with the rest.
+    if (index < 0 || index >= NumaGroupSize)
+        return;
+
+    sched_setaffinity(0, sizeof(cpu_set_t), &NumaNodeMasks[NumaGroups[index]]);
+}
+
+/// interleaveMemory() asks the kernel to spread the pages of a region
+/// round-robin over all NUMA nodes. It must be called before the pages
+/// are first touched. Returns 0 when there is nothing to interleave.
+
+int interleaveMemory(void *memory, uint64_t bytes) {
+
+    unsigned long nodemask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {0};
+    const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+
+    pthread_once(&NumaOnce, initNumaGroups);
+
+    if (NumaNodeCount <= 1)
+        return 0;
+
+    // Build the set of all nodes, ignoring any beyond our mask
+    for (int n = 0; n < NumaNodeCount; n++)
+        if (NumaNodeIds[n] < MAX_NUMA_NODES)
+            nodemask[NumaNodeIds[n] / (8 * sizeof(unsigned long))]
+                |= 1ul << (NumaNodeIds[n] % (8 * sizeof(unsigned long)));
+
+    // The policy can only be applied to whole pages
+    uint64_t start = ((uint64_t)memory + pageSize - 1) / pageSize * pageSize;
+    uint64_t end   = ((uint64_t)memory + bytes) / pageSize * pageSize;
+    if (end <= start) return 0;
+
+    return !syscall(SYS_mbind, (void*)start, end - start, MPOL_INTERLEAVE_MODE,
+                    nodemask, (unsigned long)MAX_NUMA_NODES + 1, 0);
+}
+
+#else
+
 void bindThisThread(int index) { (void)index; };
 
+int interleaveMemory(void *memory, uint64_t bytes) { (void)memory; (void)bytes; return 0; }
+
+#endif
+
 #else
 
+/// interleaveMemory() is not implemented for Windows, where pages are placed
+/// on the node of the thread which first touches them.
+
+int interleaveMemory(void *memory, uint64_t bytes) { (void)memory; (void)bytes; return 0; }
+
 /// bestGroup() retrieves logical processor information using Windows specific
 /// API and returns the best group id for the thread with a given index. Original
 /// code from Texel by Peter sterlund. Current code from Stockfish authors.
@@ -100,6 +282,10 @@ void bindThisThread(int index) {
 
   int group;
 
+  // Binding may be disabled by the UCI options
+  if (!NumaBinding)
+      return;
+
   // Check for a need to bind the thread
   if ((group = bestGroup(index)) == -1)
       return;
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "types.h"
 
 // Force to include needed API prototypes
@@ -40,3 +42,4 @@ typedef int (*fun3_t) (HANDLE, CONST GROUP_AFFINITY*, PGROUP_AFFINITY);
 #endif
 
 void bindThisThread(int index);
+int interleaveMemory(void *memory, uint64_t bytes);
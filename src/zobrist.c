@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include "bitboards.h"
 #include "castle.h"
 #include "types.h"
 #include "zobrist.h"
@@ -27,6 +28,7 @@ uint64_t ZobristKeys[32][SQUARE_NB];
 uint64_t ZobristEnpassKeys[FILE_NB];
 uint64_t ZobristCastleKeys[0x10];
 uint64_t ZobristTurnKey;
+uint64_t ZobristMaterialKeys[32][SQUARE_NB];
 
 uint64_t rand64() {
 
@@ -79,4 +81,19 @@ void initZobrist() {
 
     // Init the Zobrist key for side to move
     ZobristTurnKey = rand64();
+
+    // Init the material keys. These are summed rather than XOR'ed, so that
+    // two identical pieces do not cancel out. A piece has the same key on
+    // every square, except Bishops, which are split by square colour
+    for (int pt = PAWN; pt <= KING; pt++) {
+        for (int colour = WHITE; colour <= BLACK; colour++) {
+
+            uint64_t light = rand64();
+            uint64_t dark  = pt == BISHOP ? rand64() : light;
+
+            for (int sq = 0; sq < SQUARE_NB; sq++)
+                ZobristMaterialKeys[makePiece(pt, colour)][sq]
+                    = (WHITE_SQUARES & (1ull << sq)) ? light : dark;
+        }
+    }
 }
@@ -26,6 +26,7 @@ extern uint64_t ZobristKeys[32][SQUARE_NB];
 extern uint64_t ZobristEnpassKeys[FILE_NB];
 extern uint64_t ZobristCastleKeys[0x10];
 extern uint64_t ZobristTurnKey;
+extern uint64_t ZobristMaterialKeys[32][SQUARE_NB];
 
 uint64_t rand64();
 void initZobrist();